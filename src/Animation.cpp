@@ -0,0 +1,106 @@
+#include "Animation.h"
+
+#include <algorithm>
+
+#include "Skinning.h"
+
+namespace
+{
+    // The key one step past end, repeating the step from inner to end. Only the end segments need it
+    Motor Extrapolate(const Motor& end, const Motor& inner)
+    {
+        return end * ~inner * end;
+    }
+}
+
+MotorTrack::MotorTrack(Interpolation interpolation)
+    : m_Interpolation{ interpolation }
+{
+}
+
+void MotorTrack::Reserve(size_t count)
+{
+    m_Times.reserve(count);
+    m_Keys.reserve(count);
+    if (m_Interpolation == Interpolation::ScrewLinear) m_Screws.reserve(count);
+}
+
+void MotorTrack::Clear()
+{
+    m_Times.clear();
+    m_Keys.clear();
+    m_Screws.clear();
+}
+
+bool MotorTrack::AddKey(float time, const Motor& motor)
+{
+    if (!m_Times.empty() && !(time > m_Times.back())) return false;
+
+    if (!m_Keys.empty() && m_Interpolation == Interpolation::ScrewLinear)
+    {
+        m_Screws.push_back(ScrewMotion::Between(m_Keys.back(), motor));
+    }
+    m_Times.push_back(time);
+    m_Keys.push_back(motor);
+    return true;
+}
+
+Motor MotorTrack::Sample(float time) const
+{
+    if (m_Keys.empty()) return Motor{ 1, 0, 0, 0, 0, 0, 0, 0 };
+    return Evaluate(FindSegment(time), time);
+}
+
+Motor MotorTrack::Sample(float time, size_t& cursor) const
+{
+    if (m_Keys.empty()) return Motor{ 1, 0, 0, 0, 0, 0, 0, 0 };
+
+    //segment i runs from key i to key i + 1, the last one only holds the end key
+    const size_t last{ m_Keys.size() - 1 };
+    if (cursor > last || time < m_Times[cursor]) cursor = FindSegment(time);
+    while (cursor < last && time >= m_Times[cursor + 1]) ++cursor;
+    return Evaluate(cursor, time);
+}
+
+size_t MotorTrack::FindSegment(float time) const
+{
+    //the last key not after time, key 0 for times before the track
+    const auto next{ std::upper_bound(m_Times.begin(), m_Times.end(), time) };
+    return next == m_Times.begin() ? 0 : static_cast<size_t>(next - m_Times.begin()) - 1;
+}
+
+Motor MotorTrack::Evaluate(size_t segment, float time) const
+{
+    const size_t last{ m_Keys.size() - 1 };
+    if (segment >= last || time <= m_Times[segment]) return m_Keys[segment];
+
+    const float t{ (time - m_Times[segment]) / (m_Times[segment + 1] - m_Times[segment]) };
+    if (m_Interpolation == Interpolation::ScrewLinear) return m_Screws[segment].At(t);
+
+    //past the ends the track repeats its first and last step, a repeated end key would bend a straight track
+    //the segment start goes first so the other keys are turned to its side of M and -M
+    const Motor motors[4]{
+        m_Keys[segment],
+        segment == 0 ? Extrapolate(m_Keys[0], m_Keys[1]) : m_Keys[segment - 1],
+        m_Keys[segment + 1],
+        segment + 2 > last ? Extrapolate(m_Keys[last], m_Keys[last - 1]) : m_Keys[segment + 2] };
+    const float t2{ t * t };
+    const float t3{ t2 * t };
+    const float weights[4]{
+        (3 * t3 - 5 * t2 + 2) / 2,
+        (-t3 + 2 * t2 - t) / 2,
+        (-3 * t3 + 4 * t2 + t) / 2,
+        (t3 - t2) / 2 };
+    return skinning::Blend(motors, weights, 4);
+}
+
+namespace animation
+{
+    void SampleTracks(const std::vector<MotorTrack>& tracks, float time, std::vector<size_t>& cursors, MotorBatch& out)
+    {
+        const size_t count{ tracks.size() };
+        if (cursors.size() != count) cursors.assign(count, 0);
+        out.Resize(count);
+        for (size_t idx{}; idx < count; ++idx) out.Set(idx, tracks[idx].Sample(time, cursors[idx]));
+    }
+}
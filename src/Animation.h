@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+#include "SweptBounds.h"
+
+enum class Interpolation
+{
+    // Constant velocity screw from key to key, ScrewMotion::Between
+    ScrewLinear,
+    // Catmull-Rom weights over the four nearest keys, blended like skinning::Blend. Passes through every key
+    // with a continuous velocity, at the price of a blend that is only close to a screw between keys.
+    // The first and last step are repeated past the ends, which expects unit keys.
+    Spline
+};
+
+// Keyed motors over time. Times before the first key or after the last one hold the end key.
+// The screws between keys are solved when the keys are added, so sampling only evaluates them.
+class MotorTrack
+{
+public:
+    explicit MotorTrack(Interpolation interpolation = Interpolation::ScrewLinear);
+
+    [[nodiscard]] size_t Size() const { return m_Keys.size(); }
+    [[nodiscard]] Interpolation GetInterpolation() const { return m_Interpolation; }
+    [[nodiscard]] float KeyTime(size_t idx) const { return m_Times[idx]; }
+    [[nodiscard]] const Motor& Key(size_t idx) const { return m_Keys[idx]; }
+    [[nodiscard]] float StartTime() const { return m_Times.empty() ? 0 : m_Times.front(); }
+    [[nodiscard]] float EndTime() const { return m_Times.empty() ? 0 : m_Times.back(); }
+
+    void Reserve(size_t count);
+    void Clear();
+    // Keys go in time order, false and nothing added when time is not after the last key
+    bool AddKey(float time, const Motor& motor);
+
+    // Finds the key pair with a binary search, the identity for an empty track
+    [[nodiscard]] Motor Sample(float time) const;
+    // cursor remembers the key pair between calls: while time only moves forward it steps at most a few keys,
+    // O(1) amortized. Any cursor value is valid, 0 to start, and a jump back falls back to the binary search.
+    [[nodiscard]] Motor Sample(float time, size_t& cursor) const;
+
+private:
+    [[nodiscard]] size_t FindSegment(float time) const;
+    [[nodiscard]] Motor Evaluate(size_t segment, float time) const;
+
+    Interpolation m_Interpolation;
+    std::vector<float> m_Times{};
+    std::vector<Motor> m_Keys{};
+    // Screw from key i to key i + 1, only kept for ScrewLinear
+    std::vector<ScrewMotion> m_Screws{};
+};
+
+namespace animation
+{
+    // out[i] = tracks[i].Sample(time, cursors[i]) for every track in one pass, out is resized to tracks.size().
+    // cursors is reset to 0 when its size does not match, keep it around between frames for the O(1) path.
+    void SampleTracks(const std::vector<MotorTrack>& tracks, float time, std::vector<size_t>& cursors, MotorBatch& out);
+}
@@ -0,0 +1,256 @@
+#include "BatchFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::uint16_t Swap(std::uint16_t value)
+    {
+        return static_cast<std::uint16_t>((value >> 8) | (value << 8));
+    }
+
+    std::uint32_t Swap(std::uint32_t value)
+    {
+        return (value >> 24) | ((value >> 8) & 0x0000ff00u) | ((value << 8) & 0x00ff0000u) | (value << 24);
+    }
+
+    std::uint64_t Swap(std::uint64_t value)
+    {
+        return (static_cast<std::uint64_t>(Swap(static_cast<std::uint32_t>(value))) << 32) | Swap(static_cast<std::uint32_t>(value >> 32));
+    }
+
+    size_t ComponentCount(batchfile::ElementType type)
+    {
+        switch (type)
+        {
+        case batchfile::ElementType::Plane: return PlaneBatch::Components;
+        case batchfile::ElementType::Line: return LineBatch::Components;
+        case batchfile::ElementType::Point: return PointBatch::Components;
+        case batchfile::ElementType::Motor: return MotorBatch::Components;
+        }
+        return 0;
+    }
+
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Brings the header into the byte order of this machine and checks it against the file length
+    bool ReadHeader(const void* data, size_t length, batchfile::FileHeader& header, bool& swapped)
+    {
+        if (length < sizeof(batchfile::FileHeader)) return false;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, batchfile::g_Magic, sizeof(header.magic)) != 0) return false;
+
+        swapped = header.byteOrderTag != batchfile::g_ByteOrderTag;
+        if (swapped)
+        {
+            if (Swap(header.byteOrderTag) != batchfile::g_ByteOrderTag) return false;
+            header.byteOrderTag = batchfile::g_ByteOrderTag;
+            header.version = Swap(header.version);
+            header.type = static_cast<batchfile::ElementType>(Swap(static_cast<std::uint16_t>(header.type)));
+            header.componentCount = Swap(header.componentCount);
+            header.count = Swap(header.count);
+            header.stride = Swap(header.stride);
+            header.dataOffset = Swap(header.dataOffset);
+        }
+
+        //newer versions may change the layout, older readers cannot know how
+        if (header.version == 0 || header.version > batchfile::g_Version) return false;
+        if (header.componentCount == 0 || header.componentCount != ComponentCount(header.type)) return false;
+        if (header.stride < header.count || header.dataOffset < sizeof(batchfile::FileHeader)) return false;
+        if (header.dataOffset % batchfile::g_Alignment != 0) return false;
+
+        //division instead of multiplication so a corrupt stride cannot overflow
+        const std::uint64_t dataLength{ length - std::min<std::uint64_t>(length, header.dataOffset) };
+        return header.stride <= dataLength / sizeof(float) / header.componentCount;
+    }
+}
+
+namespace batchfile
+{
+    bool Writer::Open(const std::string& path, ElementType type, size_t count)
+    {
+        Close();
+        m_Header = FileHeader{};
+        std::memcpy(m_Header.magic, g_Magic, sizeof(m_Header.magic));
+        m_Header.byteOrderTag = g_ByteOrderTag;
+        m_Header.version = g_Version;
+        m_Header.type = type;
+        m_Header.componentCount = static_cast<std::uint32_t>(ComponentCount(type));
+        m_Header.count = count;
+        //a whole number of pages per component, also for an empty batch
+        m_Header.stride = AlignUp(count == 0 ? 1 : count, g_Alignment / sizeof(float));
+        m_Header.dataOffset = AlignUp(sizeof(FileHeader), g_Alignment);
+
+        m_File.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_File) return false;
+        m_File.write(reinterpret_cast<const char*>(&m_Header), sizeof(m_Header));
+
+        //one byte at the very end sizes the file, the gaps read back as zeros
+        const std::uint64_t length{ m_Header.dataOffset + m_Header.componentCount * m_Header.stride * sizeof(float) };
+        m_File.seekp(static_cast<std::streamoff>(length - 1));
+        m_File.put('\0');
+        return static_cast<bool>(m_File);
+    }
+
+    bool Writer::WriteRange(size_t first, const float* const* components, size_t count)
+    {
+        if (!m_File.is_open() || first > m_Header.count || count > m_Header.count - first) return false;
+        for (size_t component{}; component < m_Header.componentCount; ++component)
+        {
+            const std::uint64_t offset{ m_Header.dataOffset + (component * m_Header.stride + first) * sizeof(float) };
+            m_File.seekp(static_cast<std::streamoff>(offset));
+            m_File.write(reinterpret_cast<const char*>(components[component]), static_cast<std::streamsize>(count * sizeof(float)));
+        }
+        return static_cast<bool>(m_File);
+    }
+
+    bool Writer::Close()
+    {
+        if (!m_File.is_open()) return false;
+        m_File.flush();
+        const bool good{ static_cast<bool>(m_File) };
+        m_File.close();
+        return good;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this == &other) return *this;
+        Close();
+        m_Data = other.m_Data;
+        m_Length = other.m_Length;
+#ifdef _WIN32
+        m_Mapping = other.m_Mapping;
+        other.m_Mapping = nullptr;
+#endif
+        m_Header = other.m_Header;
+        m_Swapped = other.m_Swapped;
+        other.m_Data = nullptr;
+        other.m_Length = 0;
+        return *this;
+    }
+
+    bool MappedFile::Open(const std::string& path)
+    {
+        Close();
+
+#ifdef _WIN32
+        const HANDLE file{ CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER length{};
+        if (GetFileSizeEx(file, &length) && length.QuadPart > 0)
+        {
+            //PAGE_WRITECOPY gives the private, copy on write pages that MAP_PRIVATE gives elsewhere
+            m_Mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            if (m_Mapping != nullptr)
+            {
+                m_Data = MapViewOfFile(m_Mapping, FILE_MAP_COPY, 0, 0, 0);
+                m_Length = static_cast<size_t>(length.QuadPart);
+            }
+        }
+        CloseHandle(file);
+#else
+        const int file{ open(path.c_str(), O_RDONLY) };
+        if (file < 0) return false;
+        struct stat status{};
+        if (fstat(file, &status) == 0 && status.st_size > 0)
+        {
+            void* data{ mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0) };
+            if (data != MAP_FAILED)
+            {
+                m_Data = data;
+                m_Length = static_cast<size_t>(status.st_size);
+            }
+        }
+        close(file);
+#endif
+
+        if (m_Data == nullptr || !ReadHeader(m_Data, m_Length, m_Header, m_Swapped))
+        {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+#ifdef _WIN32
+        if (m_Data != nullptr) UnmapViewOfFile(m_Data);
+        if (m_Mapping != nullptr) CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+#else
+        if (m_Data != nullptr) munmap(m_Data, m_Length);
+#endif
+        m_Data = nullptr;
+        m_Length = 0;
+        m_Header = FileHeader{};
+        m_Swapped = false;
+    }
+
+    void MappedFile::Prefetch(size_t first, size_t count) const
+    {
+        if (!IsOpen() || first >= Size()) return;
+        count = std::min(count, Size() - first);
+        for (size_t component{}; component < m_Header.componentCount; ++component)
+        {
+            const float* start{ Components() + component * m_Header.stride + first };
+#ifdef _WIN32
+            WIN32_MEMORY_RANGE_ENTRY range{ const_cast<float*>(start), count * sizeof(float) };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+            //advice has to start on a page boundary
+            const std::uintptr_t pageSize{ static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE)) };
+            const std::uintptr_t address{ reinterpret_cast<std::uintptr_t>(start) };
+            const std::uintptr_t pageStart{ address / pageSize * pageSize };
+            madvise(reinterpret_cast<void*>(pageStart), address + count * sizeof(float) - pageStart, MADV_WILLNEED);
+#endif
+        }
+    }
+
+    void MappedFile::CopyComponent(size_t component, float* out) const
+    {
+        const float* source{ Components() + component * m_Header.stride };
+        const size_t count{ Size() };
+        if (count == 0) return;
+        if (!m_Swapped)
+        {
+            std::memcpy(out, source, count * sizeof(float));
+            return;
+        }
+
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            std::uint32_t bits{};
+            std::memcpy(&bits, source + idx, sizeof(bits));
+            bits = Swap(bits);
+            std::memcpy(out + idx, &bits, sizeof(bits));
+        }
+    }
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "FlyFishBatch.h"
+
+// Binary files holding one element batch, laid out so a memory mapping of the file is usable as is.
+//
+//   bytes 0 - 63      FileHeader, written in the byte order of the machine that wrote it
+//   dataOffset        component 0, count floats followed by zeros up to stride floats
+//   + stride * 4      component 1, ...
+//
+// dataOffset and stride * 4 are multiples of g_Alignment, so every component array starts on its own page
+// and the batch kernels read the mapped floats directly. Files are one batch each.
+namespace batchfile
+{
+    enum class ElementType : std::uint16_t
+    {
+        Plane = 1,
+        Line = 2,
+        Point = 3,
+        Motor = 4
+    };
+
+    constexpr char g_Magic[4]{ 'F', 'F', 'B', 'F' };
+    // Reads back as 0x04030201 when the file was written with the other byte order
+    constexpr std::uint32_t g_ByteOrderTag{ 0x01020304 };
+    constexpr std::uint16_t g_Version{ 1 };
+    constexpr std::size_t g_Alignment{ 4096 };
+
+    struct FileHeader
+    {
+        char magic[4];
+        std::uint32_t byteOrderTag;
+        std::uint16_t version;
+        ElementType type;
+        std::uint32_t componentCount;
+        std::uint64_t count;
+        // Floats from the start of one component array to the next
+        std::uint64_t stride;
+        // Bytes from the start of the file to component 0
+        std::uint64_t dataOffset;
+        std::uint8_t reserved[24];
+    };
+    static_assert(sizeof(FileHeader) == 64, "the header layout is part of the file format");
+
+    template <typename Batch>
+    struct BatchType;
+    template <>
+    struct BatchType<PlaneBatch> { static constexpr ElementType value{ ElementType::Plane }; };
+    template <>
+    struct BatchType<LineBatch> { static constexpr ElementType value{ ElementType::Line }; };
+    template <>
+    struct BatchType<PointBatch> { static constexpr ElementType value{ ElementType::Point }; };
+    template <>
+    struct BatchType<MotorBatch> { static constexpr ElementType value{ ElementType::Motor }; };
+
+    // Writes a batch file piece by piece, for batches too large to hold in memory at once.
+    // The header goes out on Open with the final count, the ranges may then be written in any order.
+    class Writer
+    {
+    public:
+        // Creates path with room for count elements, false when it cannot be created
+        bool Open(const std::string& path, ElementType type, size_t count);
+        // Writes chunk as the elements first .. first + chunk.Size(), false on a write error or a range past the count
+        template <typename Batch>
+        bool Write(size_t first, const Batch& chunk)
+        {
+            if (BatchType<Batch>::value != m_Header.type) return false;
+            const float* components[Batch::Components]{};
+            for (size_t component{}; component < Batch::Components; ++component)
+            {
+                components[component] = chunk.Component(component);
+            }
+            return WriteRange(first, components, chunk.Size());
+        }
+        // Flushes and closes the file, false when anything written since Open failed
+        bool Close();
+
+    private:
+        bool WriteRange(size_t first, const float* const* components, size_t count);
+
+        std::ofstream m_File{};
+        FileHeader m_Header{};
+    };
+
+    // Writes batch to path, replacing the file. false when it cannot be written.
+    template <typename Batch>
+    bool Write(const std::string& path, const Batch& batch)
+    {
+        Writer writer{};
+        return writer.Open(path, BatchType<Batch>::value, batch.Size()) && writer.Write(0, batch) && writer.Close();
+    }
+
+    // A batch file mapped copy on write: writes through a view stay in this process and never reach the file.
+    // Views handed out by View point into the mapping and must not outlive it.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Maps path and checks the header, false when the file is missing, truncated or not a batch file
+        bool Open(const std::string& path);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return m_Data != nullptr; }
+        // The header in the byte order of this machine
+        [[nodiscard]] const FileHeader& Header() const { return m_Header; }
+        [[nodiscard]] ElementType Type() const { return m_Header.type; }
+        [[nodiscard]] size_t Size() const { return static_cast<size_t>(m_Header.count); }
+        // false when the floats need swapping before use, View refuses such files and Read converts them
+        [[nodiscard]] bool IsNativeByteOrder() const { return !m_Swapped; }
+
+        // Asks the system to start reading elements first .. first + count in, so a later pass over them does not stall
+        void Prefetch(size_t first, size_t count) const;
+
+        // Points out at the mapped floats without copying anything. false when the file holds another element type,
+        // is not open or was written with the other byte order.
+        template <typename Batch>
+        bool View(Batch& out)
+        {
+            if (!IsOpen() || !IsNativeByteOrder() || m_Header.type != BatchType<Batch>::value) return false;
+            out = Batch::View(Components(), Size(), static_cast<size_t>(m_Header.stride));
+            return true;
+        }
+
+        // Copies the file into an owning batch, swapping bytes for files from the other byte order
+        template <typename Batch>
+        bool Read(Batch& out) const
+        {
+            if (!IsOpen() || m_Header.type != BatchType<Batch>::value) return false;
+            out.Resize(Size());
+            for (size_t component{}; component < Batch::Components; ++component)
+            {
+                CopyComponent(component, out.Component(component));
+            }
+            return true;
+        }
+
+    private:
+        [[nodiscard]] float* Components() const { return reinterpret_cast<float*>(static_cast<char*>(m_Data) + m_Header.dataOffset); }
+        void CopyComponent(size_t component, float* out) const;
+
+        void* m_Data{};
+        size_t m_Length{};
+#ifdef _WIN32
+        void* m_Mapping{};
+#endif
+        FileHeader m_Header{};
+        bool m_Swapped{};
+    };
+
+    // Open and Read in one go, the file is unmapped again afterwards
+    template <typename Batch>
+    bool Read(const std::string& path, Batch& out)
+    {
+        MappedFile file{};
+        return file.Open(path) && file.Read(out);
+    }
+}
@@ -0,0 +1,132 @@
+#include "Benchmark.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+	std::string JsonString(const std::string& text)
+	{
+		std::string quoted{ "\"" };
+		for (const char character : text)
+		{
+			if (character == '"' || character == '\\') quoted += '\\';
+			quoted += character;
+		}
+		return quoted + '"';
+	}
+
+	// Fixed width cell, a dash for events that were not counted
+	void PrintCount(double value, const char* format)
+	{
+		if (std::isnan(value)) std::printf(" %10s", "-");
+		else std::printf(format, value);
+	}
+
+	std::string JsonNumber(double value)
+	{
+		if (std::isnan(value)) return "null";
+		char text[32]{};
+		std::snprintf(text, sizeof(text), "%.4f", value);
+		return text;
+	}
+}
+
+BenchmarkRunner::BenchmarkRunner(double minSecondsPerCase, int repetitions)
+	: m_MinSecondsPerCase{ minSecondsPerCase }
+	, m_Repetitions{ repetitions }
+{
+}
+
+BenchmarkRunner::~BenchmarkRunner() = default;
+
+bool BenchmarkRunner::EnableCounters()
+{
+	m_Counters = std::make_unique<PerfCounters>();
+	if (m_Counters->Available()) return true;
+
+	std::printf("hardware counters unavailable, timing only (%s)\n", m_Counters->Error().c_str());
+	m_Counters.reset();
+	return false;
+}
+
+void BenchmarkRunner::StartCounters()
+{
+	if (!m_Counters) return;
+	m_Counters->Reset();
+	m_Counters->Start();
+}
+
+void BenchmarkRunner::StopCounters()
+{
+	if (m_Counters) m_Counters->Stop();
+}
+
+BenchmarkCounters BenchmarkRunner::CountersPerOperation(double operations) const
+{
+	const auto perOperation{ [&](PerfCounters::Event event)
+		{
+			return m_Counters ? m_Counters->Count(event) / operations : std::nan("");
+		} };
+	return BenchmarkCounters{
+		perOperation(PerfCounters::Cycles),
+		perOperation(PerfCounters::Instructions),
+		perOperation(PerfCounters::L1Misses),
+		perOperation(PerfCounters::LLCMisses),
+		perOperation(PerfCounters::BranchMisses) };
+}
+
+void BenchmarkRunner::PrintHeader(const std::string& title)
+{
+	m_Section = title;
+	std::printf("\n----- %s -----\n", title.c_str());
+	std::printf("%-48s %12s %16s", "benchmark", "ns/op", "ops/s");
+	if (m_Counters) std::printf(" %10s %10s %10s %10s %10s %10s", "cycles/op", "instr/op", "IPC", "L1 miss/op", "LLC miss", "br miss/op");
+	std::printf("\n");
+}
+
+void BenchmarkRunner::PrintResult(const BenchmarkResult& result) const
+{
+	std::printf("%-48s %12.3f %16.0f", result.name.c_str(), result.nsPerOp, result.opsPerSecond);
+	if (m_Counters)
+	{
+		const BenchmarkCounters& counters{ result.counters };
+		PrintCount(counters.cycles, " %10.2f");
+		PrintCount(counters.instructions, " %10.2f");
+		PrintCount(counters.instructions / counters.cycles, " %10.2f");
+		PrintCount(counters.l1Misses, " %10.4f");
+		PrintCount(counters.llcMisses, " %10.4f");
+		PrintCount(counters.branchMisses, " %10.4f");
+	}
+	std::printf("\n");
+}
+
+bool BenchmarkRunner::WriteJson(const std::string& path) const
+{
+	std::ofstream file{ path };
+	if (!file) return false;
+
+	file << "{\n  \"results\": [";
+	for (size_t idx{}; idx < m_Results.size(); ++idx)
+	{
+		const BenchmarkResult& result{ m_Results[idx] };
+		char numbers[128]{};
+		std::snprintf(numbers, sizeof(numbers), "\"ns_per_op\": %.4f, \"ops_per_second\": %.1f, \"operations\": %zu",
+			result.nsPerOp, result.opsPerSecond, result.operations);
+		file << (idx == 0 ? "\n" : ",\n") << "    { \"section\": " << JsonString(result.section)
+			<< ", \"name\": " << JsonString(result.name) << ", " << numbers;
+		if (m_Counters)
+		{
+			const BenchmarkCounters& counters{ result.counters };
+			file << ", \"cycles_per_op\": " << JsonNumber(counters.cycles)
+				<< ", \"instructions_per_op\": " << JsonNumber(counters.instructions)
+				<< ", \"ipc\": " << JsonNumber(counters.instructions / counters.cycles)
+				<< ", \"l1_misses_per_op\": " << JsonNumber(counters.l1Misses)
+				<< ", \"llc_misses_per_op\": " << JsonNumber(counters.llcMisses)
+				<< ", \"branch_misses_per_op\": " << JsonNumber(counters.branchMisses);
+		}
+		file << " }";
+	}
+	file << "\n  ]\n}\n";
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "PerfCounters.h"
+
+// Hardware events per operation, NaN for the ones that could not be counted
+struct BenchmarkCounters
+{
+	double cycles;
+	double instructions;
+	double l1Misses;
+	double llcMisses;
+	double branchMisses;
+};
+
+struct BenchmarkResult
+{
+	std::string section;
+	std::string name;
+	double nsPerOp;
+	double opsPerSecond;
+	size_t operations;
+	BenchmarkCounters counters;
+};
+
+class BenchmarkRunner
+{
+public:
+	explicit BenchmarkRunner(double minSecondsPerCase = 0.2, int repetitions = 5);
+	~BenchmarkRunner();
+
+	// Counts hardware events during the timed repetitions of every following Run and reports them per operation.
+	// Returns false, and keeps timing only, when no counter is available.
+	bool EnableCounters();
+
+	// Times func, which performs opsPerCall operations per call, and keeps the fastest repetition
+	template <typename Func>
+	const BenchmarkResult& Run(const std::string& name, size_t opsPerCall, Func&& func)
+	{
+		//warm up caches and find a call count that runs long enough to time
+		size_t calls{ 1 };
+		while (TimeCalls(calls, func) < m_MinSecondsPerCase / m_Repetitions && calls < (size_t{ 1 } << 40))
+		{
+			calls *= 2;
+		}
+
+		//counted over every repetition, the slow ones included, since the counts hardly vary
+		StartCounters();
+		double bestSeconds{ TimeCalls(calls, func) };
+		for (int repetition{ 1 }; repetition < m_Repetitions; ++repetition)
+		{
+			bestSeconds = std::min(bestSeconds, TimeCalls(calls, func));
+		}
+		StopCounters();
+
+		const double operations{ static_cast<double>(calls) * static_cast<double>(opsPerCall) };
+		m_Results.push_back(BenchmarkResult{
+			m_Section,
+			name,
+			bestSeconds * 1e9 / operations,
+			operations / bestSeconds,
+			static_cast<size_t>(operations),
+			CountersPerOperation(operations * m_Repetitions) });
+		PrintResult(m_Results.back());
+		return m_Results.back();
+	}
+
+	const std::vector<BenchmarkResult>& GetResults() const { return m_Results; }
+
+	// Starts a new section, the results that follow are grouped under title
+	void PrintHeader(const std::string& title);
+
+	// Writes every result so far as JSON, for comparing runs over time. false when path cannot be written.
+	bool WriteJson(const std::string& path) const;
+
+	// Keeps the compiler from dropping stores that are never read back
+	static void ClobberMemory()
+	{
+#if defined(_MSC_VER)
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : : "memory");
+#endif
+	}
+
+private:
+	double m_MinSecondsPerCase;
+	int m_Repetitions;
+	std::vector<BenchmarkResult> m_Results{};
+	std::string m_Section{};
+	std::unique_ptr<PerfCounters> m_Counters{};
+
+	void StartCounters();
+	void StopCounters();
+	[[nodiscard]] BenchmarkCounters CountersPerOperation(double operations) const;
+
+	template <typename Func>
+	static double TimeCalls(size_t calls, Func& func)
+	{
+		const auto start{ std::chrono::steady_clock::now() };
+		for (size_t call{}; call < calls; ++call)
+		{
+			func();
+			ClobberMemory();
+		}
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void PrintResult(const BenchmarkResult& result) const;
+};
@@ -0,0 +1,1630 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Animation.h"
+#include "BatchFile.h"
+#include "Benchmark.h"
+#include "CliffordAlgebra.h"
+#include "CompactMotor.h"
+#include "ConvexShape.h"
+#include "Dynamics.h"
+#include "ElementText.h"
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+#include "InverseKinematics.h"
+#include "Jacobian.h"
+#include "MotorChain.h"
+#include "MotorEstimation.h"
+#include "Orbit.h"
+#include "Projection.h"
+#include "Raycast.h"
+#include "Reduction.h"
+#include "SceneGraph.h"
+#include "Skinning.h"
+#include "SpatialHash.h"
+#include "SweptBounds.h"
+
+namespace
+{
+	constexpr size_t g_ElementCount{ 1024 };
+
+	std::mt19937 g_Random{ 1234 };
+
+	float RandomFloat()
+	{
+		std::uniform_real_distribution<float> distribution{ -1.f, 1.f };
+		return distribution(g_Random);
+	}
+
+	Motor RandomMotor()
+	{
+		Motor motor{ RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat(),
+			RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat() };
+		return motor.Normalized();
+	}
+
+	ThreeBlade RandomPoint()
+	{
+		return ThreeBlade{ RandomFloat() * 100.f, RandomFloat() * 100.f, RandomFloat() * 100.f };
+	}
+
+	OneBlade RandomPlane()
+	{
+		return OneBlade{ RandomFloat() * 100.f, RandomFloat(), RandomFloat(), RandomFloat() };
+	}
+
+	// FlyFish stores e23, e31, e12 and e032, e013, e021; the generated algebra uses canonical blade order
+	PGA3D::Even ToGeneric(const Motor& m)
+	{
+		return PGA3D::Even{ m[0], m[1], m[2], m[6], m[3], -m[5], m[4], m[7] };
+	}
+	PGA3D::Trivector ToGeneric(const ThreeBlade& p)
+	{
+		return PGA3D::Trivector{ -p[2], p[1], -p[0], p[3] };
+	}
+	PGA3D::Vector ToGeneric(const OneBlade& p)
+	{
+		return PGA3D::Vector{ p[0], p[1], p[2], p[3] };
+	}
+
+	template <typename T, typename Convert>
+	auto ConvertAll(const std::vector<T>& source, Convert convert)
+	{
+		std::vector<decltype(convert(source[0]))> result{};
+		result.reserve(source.size());
+		for (const auto& element : source) result.push_back(convert(element));
+		return result;
+	}
+
+	void BenchmarkGeneratedAlgebra(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("R(3,0,1) generated vs hand-written FlyFish");
+
+		std::vector<Motor> motorsA{}, motorsB{};
+		std::vector<ThreeBlade> pointsA{}, pointsB{};
+		std::vector<OneBlade> planesA{}, planesB{};
+		for (size_t idx{}; idx < g_ElementCount; ++idx)
+		{
+			motorsA.push_back(RandomMotor());
+			motorsB.push_back(RandomMotor());
+			pointsA.push_back(RandomPoint());
+			pointsB.push_back(RandomPoint());
+			planesA.push_back(RandomPlane());
+			planesB.push_back(RandomPlane());
+		}
+
+		auto toMotor = [](const Motor& m) { return ToGeneric(m); };
+		auto toPoint = [](const ThreeBlade& p) { return ToGeneric(p); };
+		auto toPlane = [](const OneBlade& p) { return ToGeneric(p); };
+		const auto genericMotorsA{ ConvertAll(motorsA, toMotor) };
+		const auto genericMotorsB{ ConvertAll(motorsB, toMotor) };
+		const auto genericPointsA{ ConvertAll(pointsA, toPoint) };
+		const auto genericPointsB{ ConvertAll(pointsB, toPoint) };
+		const auto genericPlanesA{ ConvertAll(planesA, toPlane) };
+		const auto genericPlanesB{ ConvertAll(planesB, toPlane) };
+
+		std::vector<Motor> motorOut(g_ElementCount);
+		std::vector<PGA3D::Even> genericMotorOut(g_ElementCount);
+		runner.Run("FlyFish   Motor * Motor", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) motorOut[idx] = motorsA[idx] * motorsB[idx];
+			});
+		runner.Run("Generated Even * Even", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) genericMotorOut[idx] = genericMotorsA[idx] * genericMotorsB[idx];
+			});
+
+		std::vector<ThreeBlade> pointOut(g_ElementCount);
+		std::vector<PGA3D::Trivector> genericPointOut(g_ElementCount);
+		runner.Run("FlyFish   (Motor * ThreeBlade * ~Motor).Grade3()", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) pointOut[idx] = (motorsA[idx] * pointsA[idx] * ~motorsA[idx]).Grade3();
+			});
+		runner.Run("Generated Sandwich(Even, Trivector)", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) genericPointOut[idx] = Sandwich(genericMotorsA[idx], genericPointsA[idx]);
+			});
+
+		std::vector<TwoBlade> lineOut(g_ElementCount);
+		std::vector<PGA3D::Bivector> genericLineOut(g_ElementCount);
+		runner.Run("FlyFish   ThreeBlade & ThreeBlade", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) lineOut[idx] = pointsA[idx] & pointsB[idx];
+			});
+		runner.Run("Generated Trivector & Trivector", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) genericLineOut[idx] = genericPointsA[idx] & genericPointsB[idx];
+			});
+		runner.Run("FlyFish   OneBlade ^ OneBlade", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) lineOut[idx] = planesA[idx] ^ planesB[idx];
+			});
+		runner.Run("Generated Vector ^ Vector", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) genericLineOut[idx] = genericPlanesA[idx] ^ genericPlanesB[idx];
+			});
+
+		//the generated code has to agree with the hand-written kernels, not only be as fast
+		float maxError{};
+		for (size_t idx{}; idx < g_ElementCount; ++idx)
+		{
+			const auto product{ ToGeneric(motorsA[idx] * motorsB[idx]) };
+			const auto genericProduct{ genericMotorsA[idx] * genericMotorsB[idx] };
+			for (size_t component{}; component < product.Size; ++component)
+			{
+				maxError = std::max(maxError, std::fabs(product[component] - genericProduct[component]));
+			}
+
+			const auto point{ ToGeneric((motorsA[idx] * pointsA[idx] * ~motorsA[idx]).Grade3()) };
+			const auto genericPoint{ Sandwich(genericMotorsA[idx], genericPointsA[idx]) };
+			for (size_t component{}; component < point.Size; ++component)
+			{
+				maxError = std::max(maxError, std::fabs(point[component] - genericPoint[component]));
+			}
+		}
+		std::printf("max difference generated vs FlyFish: %g\n", maxError);
+	}
+
+	template <typename Element>
+	Element RandomElement();
+	template <>
+	OneBlade RandomElement<OneBlade>() { return RandomPlane(); }
+	template <>
+	TwoBlade RandomElement<TwoBlade>() { return RandomPoint() & RandomPoint(); }
+	template <>
+	ThreeBlade RandomElement<ThreeBlade>() { return RandomPoint(); }
+	template <>
+	Motor RandomElement<Motor>() { return RandomMotor(); }
+	template <>
+	MultiVector RandomElement<MultiVector>()
+	{
+		MultiVector element{};
+		for (size_t component{}; component < 16; ++component) element[component] = RandomFloat();
+		return element;
+	}
+
+	template <typename Element>
+	constexpr const char* g_TypeName{ "" };
+	template <>
+	constexpr const char* g_TypeName<OneBlade>{ "OneBlade" };
+	template <>
+	constexpr const char* g_TypeName<TwoBlade>{ "TwoBlade" };
+	template <>
+	constexpr const char* g_TypeName<ThreeBlade>{ "ThreeBlade" };
+	template <>
+	constexpr const char* g_TypeName<Motor>{ "Motor" };
+	template <>
+	constexpr const char* g_TypeName<MultiVector>{ "MultiVector" };
+
+	template <typename Element>
+	std::vector<Element> RandomElements()
+	{
+		std::vector<Element> elements{};
+		for (size_t idx{}; idx < g_ElementCount; ++idx) elements.push_back(RandomElement<Element>());
+		return elements;
+	}
+
+	// Times operation(a[i]) over g_ElementCount random elements
+	template <typename Element, typename Operation>
+	void RunUnary(BenchmarkRunner& runner, const std::string& name, const Operation& operation)
+	{
+		const std::vector<Element> elements{ RandomElements<Element>() };
+		std::vector<decltype(operation(elements[0]))> out(g_ElementCount);
+		runner.Run(name, g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) out[idx] = operation(elements[idx]);
+			});
+	}
+
+	// Times operation(a[i], b[i]), skipped for pairs whose result is always zero (GANull)
+	template <typename Left, typename Right, typename Operation>
+	void RunBinary(BenchmarkRunner& runner, const char* symbol, const Operation& operation)
+	{
+		using Result = decltype(operation(std::declval<const Left&>(), std::declval<const Right&>()));
+		if constexpr (!std::is_same_v<Result, GANull>)
+		{
+			const std::vector<Left> left{ RandomElements<Left>() };
+			const std::vector<Right> right{ RandomElements<Right>() };
+			std::vector<Result> out(g_ElementCount);
+			runner.Run(std::string{ g_TypeName<Left> } + " " + symbol + " " + g_TypeName<Right>, g_ElementCount, [&]
+				{
+					for (size_t idx{}; idx < g_ElementCount; ++idx) out[idx] = operation(left[idx], right[idx]);
+				});
+		}
+	}
+
+	template <typename Left, typename Operation>
+	void RunBinaryWithEveryRight(BenchmarkRunner& runner, const char* symbol, const Operation& operation)
+	{
+		RunBinary<Left, OneBlade>(runner, symbol, operation);
+		RunBinary<Left, TwoBlade>(runner, symbol, operation);
+		RunBinary<Left, ThreeBlade>(runner, symbol, operation);
+		RunBinary<Left, Motor>(runner, symbol, operation);
+		RunBinary<Left, MultiVector>(runner, symbol, operation);
+	}
+
+	template <typename Operation>
+	void RunBinaryWithEveryPair(BenchmarkRunner& runner, const char* symbol, const Operation& operation)
+	{
+		RunBinaryWithEveryRight<OneBlade>(runner, symbol, operation);
+		RunBinaryWithEveryRight<TwoBlade>(runner, symbol, operation);
+		RunBinaryWithEveryRight<ThreeBlade>(runner, symbol, operation);
+		RunBinaryWithEveryRight<Motor>(runner, symbol, operation);
+		RunBinaryWithEveryRight<MultiVector>(runner, symbol, operation);
+	}
+
+	template <typename Element>
+	void RunUnaryOperators(BenchmarkRunner& runner)
+	{
+		const std::string name{ g_TypeName<Element> };
+		RunUnary<Element>(runner, "!" + name, [](const Element& element) { return !element; });
+		RunUnary<Element>(runner, "~" + name, [](const Element& element) { return ~element; });
+		RunUnary<Element>(runner, name + "::Normalized", [](const Element& element) { return element.Normalized(); });
+		RunUnary<Element>(runner, name + "::Norm", [](const Element& element) { return element.Norm(); });
+	}
+
+	void BenchmarkFlyFishOperators(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("FlyFish operators, every overload");
+
+		RunUnaryOperators<OneBlade>(runner);
+		RunUnaryOperators<TwoBlade>(runner);
+		RunUnaryOperators<ThreeBlade>(runner);
+		RunUnaryOperators<Motor>(runner);
+		RunUnaryOperators<MultiVector>(runner);
+		RunUnary<MultiVector>(runner, "MultiVector::Grade1", [](const MultiVector& element) { return element.Grade1(); });
+		RunUnary<MultiVector>(runner, "MultiVector::Grade2", [](const MultiVector& element) { return element.Grade2(); });
+		RunUnary<MultiVector>(runner, "MultiVector::Grade3", [](const MultiVector& element) { return element.Grade3(); });
+		RunUnary<Motor>(runner, "Motor::Grade2", [](const Motor& element) { return element.Grade2(); });
+
+		RunBinaryWithEveryPair(runner, "*", [](const auto& a, const auto& b) { return a * b; });
+		RunBinaryWithEveryPair(runner, "|", [](const auto& a, const auto& b) { return a | b; });
+		RunBinaryWithEveryPair(runner, "^", [](const auto& a, const auto& b) { return a ^ b; });
+		RunBinaryWithEveryPair(runner, "&", [](const auto& a, const auto& b) { return a & b; });
+	}
+
+	// Row major 4x4 matrix acting on column vectors, the usual engine baseline
+	struct Matrix4
+	{
+		float m[4][4];
+
+		Matrix4 operator*(const Matrix4& other) const
+		{
+			Matrix4 result{};
+			for (int row{}; row < 4; ++row)
+			{
+				for (int column{}; column < 4; ++column)
+				{
+					result.m[row][column] = m[row][0] * other.m[0][column] + m[row][1] * other.m[1][column]
+						+ m[row][2] * other.m[2][column] + m[row][3] * other.m[3][column];
+				}
+			}
+			return result;
+		}
+
+		// Point with w = 1, the last row is taken to be (0, 0, 0, 1)
+		void TransformPoint(const float in[3], float out[3]) const
+		{
+			for (int row{}; row < 3; ++row) out[row] = m[row][0] * in[0] + m[row][1] * in[1] + m[row][2] * in[2] + m[row][3];
+		}
+
+		static Matrix4 Translation(float x, float y, float z)
+		{
+			return Matrix4{ { { 1, 0, 0, x }, { 0, 1, 0, y }, { 0, 0, 1, z }, { 0, 0, 0, 1 } } };
+		}
+
+		// Rotation around the z axis by angle degrees, the only rotation the game uses
+		static Matrix4 RotationZ(float angle)
+		{
+			const float radians{ angle * DEG_TO_RAD };
+			const float cosine{ std::cos(radians) }, sine{ std::sin(radians) };
+			return Matrix4{ { { cosine, -sine, 0, 0 }, { sine, cosine, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } };
+		}
+	};
+
+	struct Quaternion
+	{
+		float w, x, y, z;
+
+		Quaternion operator*(const Quaternion& o) const
+		{
+			return Quaternion{
+				w * o.w - x * o.x - y * o.y - z * o.z,
+				w * o.x + x * o.w + y * o.z - z * o.y,
+				w * o.y - x * o.z + y * o.w + z * o.x,
+				w * o.z + x * o.y - y * o.x + z * o.w };
+		}
+
+		// v + 2 w (q x v) + 2 q x (q x v) for a unit quaternion
+		void Rotate(const float in[3], float out[3]) const
+		{
+			const float tx{ 2 * (y * in[2] - z * in[1]) };
+			const float ty{ 2 * (z * in[0] - x * in[2]) };
+			const float tz{ 2 * (x * in[1] - y * in[0]) };
+			out[0] = in[0] + w * tx + (y * tz - z * ty);
+			out[1] = in[1] + w * ty + (z * tx - x * tz);
+			out[2] = in[2] + w * tz + (x * ty - y * tx);
+		}
+	};
+
+	Matrix4 RandomMatrix()
+	{
+		return Matrix4::Translation(RandomFloat(), RandomFloat(), RandomFloat()) * Matrix4::RotationZ(180 * RandomFloat());
+	}
+
+	Quaternion RandomQuaternion()
+	{
+		Quaternion q{ RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat() };
+		const float invNorm{ 1 / std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z) };
+		return Quaternion{ q.w * invNorm, q.x * invNorm, q.y * invNorm, q.z * invNorm };
+	}
+
+	void BenchmarkGamePatterns(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Game patterns, FlyFish vs matrix and quaternion");
+
+		std::vector<ThreeBlade> points{ RandomElements<ThreeBlade>() };
+		std::vector<float> pointsXYZ(g_ElementCount * 3);
+		for (size_t idx{}; idx < g_ElementCount; ++idx)
+		{
+			for (size_t axis{}; axis < 3; ++axis) pointsXYZ[idx * 3 + axis] = points[idx][axis];
+		}
+		std::vector<float> angles(g_ElementCount);
+		for (float& angle : angles) angle = 180 * RandomFloat();
+
+		std::vector<ThreeBlade> pointOut(g_ElementCount);
+		std::vector<float> xyzOut(g_ElementCount * 3);
+
+		//the compositions on their own
+		const std::vector<Motor> motorsA{ RandomElements<Motor>() }, motorsB{ RandomElements<Motor>() };
+		std::vector<Motor> motorOut(g_ElementCount);
+		runner.Run("FlyFish    Motor * Motor", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) motorOut[idx] = motorsA[idx] * motorsB[idx];
+			});
+		std::vector<Matrix4> matricesA(g_ElementCount), matricesB(g_ElementCount), matrixOut(g_ElementCount);
+		for (size_t idx{}; idx < g_ElementCount; ++idx)
+		{
+			matricesA[idx] = RandomMatrix();
+			matricesB[idx] = RandomMatrix();
+		}
+		runner.Run("Matrix4    Matrix4 * Matrix4", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) matrixOut[idx] = matricesA[idx] * matricesB[idx];
+			});
+		std::vector<Quaternion> quaternionsA(g_ElementCount), quaternionsB(g_ElementCount), quaternionOut(g_ElementCount);
+		for (size_t idx{}; idx < g_ElementCount; ++idx)
+		{
+			quaternionsA[idx] = RandomQuaternion();
+			quaternionsB[idx] = RandomQuaternion();
+		}
+		runner.Run("Quaternion Quaternion * Quaternion", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) quaternionOut[idx] = quaternionsA[idx] * quaternionsB[idx];
+			});
+
+		//Game::Update, the player moves along its direction line
+		const TwoBlade direction{ 0.6f, 0.8f, 0, 0, 0, 0 };
+		runner.Run("FlyFish    translate point", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx)
+				{
+					const Motor translation{ Motor::Translation(angles[idx], direction) };
+					pointOut[idx] = (translation * points[idx] * ~translation).Grade3();
+				}
+			});
+		runner.Run("Matrix4    translate point", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx)
+				{
+					const Matrix4 translation{ Matrix4::Translation(angles[idx] * 0.6f, angles[idx] * 0.8f, 0) };
+					translation.TransformPoint(&pointsXYZ[idx * 3], &xyzOut[idx * 3]);
+				}
+			});
+
+		//Game::ManageRotation, the player circles the selected pillar
+		const ThreeBlade pillar{ 320, 240, 0 };
+		const TwoBlade axis{ 0, 0, 0, 0, 0, 1 };
+		runner.Run("FlyFish    rotate point around pillar", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx)
+				{
+					const Motor translator{ Motor::Translation(pillar.VNorm(), TwoBlade{ pillar[0], pillar[1], 0, 0, 0, 0 }) };
+					const Motor rotation{ Motor::Rotation(angles[idx], axis) };
+					const Motor around{ translator * rotation * ~translator };
+					pointOut[idx] = (around * points[idx] * ~around).Grade3();
+				}
+			});
+		runner.Run("Matrix4    rotate point around pillar", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx)
+				{
+					const Matrix4 around{ Matrix4::Translation(pillar[0], pillar[1], 0) * Matrix4::RotationZ(angles[idx])
+						* Matrix4::Translation(-pillar[0], -pillar[1], 0) };
+					around.TransformPoint(&pointsXYZ[idx * 3], &xyzOut[idx * 3]);
+				}
+			});
+		runner.Run("Quaternion rotate point around pillar", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx)
+				{
+					const float halfAngle{ angles[idx] * DEG_TO_RAD / 2 };
+					const Quaternion rotation{ std::cos(halfAngle), 0, 0, std::sin(halfAngle) };
+					const float offset[3]{ pointsXYZ[idx * 3] - pillar[0], pointsXYZ[idx * 3 + 1] - pillar[1], pointsXYZ[idx * 3 + 2] };
+					rotation.Rotate(offset, &xyzOut[idx * 3]);
+					xyzOut[idx * 3] += pillar[0];
+					xyzOut[idx * 3 + 1] += pillar[1];
+				}
+			});
+
+		//the same circle in closed form, set up once per orbit and evaluated at any time
+		const Motor toPillar{ Motor::Translation(pillar.VNorm(), TwoBlade{ pillar[0], pillar[1], 0, 0, 0, 0 }) };
+		const TwoBlade pillarAxis{ (toPillar * axis * ~toPillar).Grade2() };
+		std::vector<Orbit> orbits{};
+		for (size_t idx{}; idx < g_ElementCount; ++idx) orbits.emplace_back(pillarAxis, points[idx], 66.f);
+		runner.Run("Orbit      rotate point around pillar", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) pointOut[idx] = orbits[idx].At(angles[idx] / 66.f);
+			});
+
+		//ten minutes of 144 Hz frames: per frame motors pile up rounding error, the closed form has none to pile up
+		constexpr size_t frameCount{ 144 * 600 };
+		constexpr float frameTime{ 1.f / 144 };
+		const ThreeBlade start{ pillar[0] + 100, pillar[1], 0 };
+		ThreeBlade accumulated{ start };
+		for (size_t frame{}; frame < frameCount; ++frame)
+		{
+			const Motor rotation{ Motor::Rotation(66.f * frameTime, axis) };
+			const Motor around{ toPillar * rotation * ~toPillar };
+			accumulated = (around * accumulated * ~around).Grade3();
+		}
+		const Orbit orbit{ pillarAxis, start, 66.f };
+		const ThreeBlade evaluated{ orbit.At(frameCount * frameTime) };
+		const auto radiusError = [&](const ThreeBlade& point)
+			{
+				return std::fabs(std::hypot(point[0] / point[3] - pillar[0], point[1] / point[3] - pillar[1]) - 100);
+			};
+		std::printf("radius error after %zu frames around the pillar: per frame motors %.3g, Orbit %.3g\n",
+			frameCount, radiusError(accumulated), radiusError(evaluated));
+
+		//Game::Update, the direction bounces off a window boundary
+		std::vector<OneBlade> planes{ RandomElements<OneBlade>() };
+		std::vector<TwoBlade> directions(g_ElementCount), directionOut(g_ElementCount);
+		for (size_t idx{}; idx < g_ElementCount; ++idx)
+		{
+			planes[idx].Normalize();
+			directions[idx] = TwoBlade{ RandomFloat(), RandomFloat(), RandomFloat(), 0, 0, 0 };
+		}
+		runner.Run("FlyFish    reflect direction in plane", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx) directionOut[idx] = (planes[idx] * directions[idx] * ~planes[idx]).Grade2();
+			});
+		runner.Run("Vector     reflect direction in plane", g_ElementCount, [&]
+			{
+				for (size_t idx{}; idx < g_ElementCount; ++idx)
+				{
+					const float* normal{ &planes[idx][1] };
+					const float* in{ &directions[idx][0] };
+					const float twiceDot{ 2 * (in[0] * normal[0] + in[1] * normal[1] + in[2] * normal[2]) };
+					for (size_t axis{}; axis < 3; ++axis) xyzOut[idx * 3 + axis] = in[axis] - twiceDot * normal[axis];
+				}
+			});
+	}
+
+	void BenchmarkBatchDistances(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Batch distance queries");
+
+		constexpr size_t pointCount{ 4096 };
+		constexpr size_t planeCount{ 4 };
+		constexpr size_t lineCount{ 8 };
+
+		std::vector<ThreeBlade> points{};
+		std::vector<OneBlade> planes{};
+		std::vector<TwoBlade> lines{};
+		for (size_t idx{}; idx < pointCount; ++idx) points.push_back(RandomPoint());
+		for (size_t idx{}; idx < planeCount; ++idx) planes.push_back(RandomPlane().Normalized());
+		for (size_t idx{}; idx < lineCount; ++idx) lines.push_back((RandomPoint() & RandomPoint()).Normalized());
+
+		const PointBatch pointBatch{ points };
+		const PlaneBatch planeBatch{ planes };
+		const LineBatch lineBatch{ lines };
+		std::vector<float> distances(pointCount * lineCount);
+		std::vector<int> hits(pointCount);
+
+		runner.Run("scalar  plane & point", pointCount * planeCount, [&]
+			{
+				for (size_t plane{}; plane < planeCount; ++plane)
+				{
+					for (size_t point{}; point < pointCount; ++point) distances[plane * pointCount + point] = planes[plane] & points[point];
+				}
+			});
+		runner.Run("batch   PointPlaneDistances", pointCount * planeCount, [&]
+			{
+				batch::PointPlaneDistances(pointBatch, planeBatch, distances.data());
+			});
+		runner.Run("batch   PointPlaneHits (threshold 10)", pointCount * planeCount, [&]
+			{
+				batch::PointPlaneHits(pointBatch, planeBatch, 10.f, hits.data());
+			});
+		runner.Run("scalar  (line & point).Norm()", pointCount * lineCount, [&]
+			{
+				for (size_t line{}; line < lineCount; ++line)
+				{
+					for (size_t point{}; point < pointCount; ++point) distances[line * pointCount + point] = (lines[line] & points[point]).Norm();
+				}
+			});
+		runner.Run("batch   PointLineDistances", pointCount * lineCount, [&]
+			{
+				batch::PointLineDistances(pointBatch, lineBatch, distances.data());
+			});
+		runner.Run("batch   LineLineDistances", lineCount * lineCount, [&]
+			{
+				batch::LineLineDistances(lineBatch, lineBatch, distances.data());
+			});
+	}
+
+	void BenchmarkBatchJoinMeet(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Batch join and meet");
+
+		constexpr size_t count{ 4096 };
+
+		std::vector<ThreeBlade> pointsA{}, pointsB{};
+		std::vector<OneBlade> planesA{}, planesB{};
+		for (size_t idx{}; idx < count; ++idx)
+		{
+			pointsA.push_back(RandomPoint());
+			pointsB.push_back(RandomPoint());
+			planesA.push_back(RandomPlane());
+			planesB.push_back(RandomPlane());
+		}
+		const PointBatch pointBatchA{ pointsA }, pointBatchB{ pointsB };
+		const PlaneBatch planeBatchA{ planesA }, planeBatchB{ planesB };
+
+		std::vector<TwoBlade> lines(count);
+		std::vector<ThreeBlade> points(count);
+		LineBatch lineBatch{};
+		PointBatch pointBatch{};
+
+		runner.Run("scalar  ThreeBlade & ThreeBlade", count, [&]
+			{
+				for (size_t idx{}; idx < count; ++idx) lines[idx] = pointsA[idx] & pointsB[idx];
+			});
+		runner.Run("batch   JoinPoints", count, [&]
+			{
+				batch::JoinPoints(pointBatchA, pointBatchB, lineBatch);
+			});
+		runner.Run("scalar  OneBlade ^ OneBlade", count, [&]
+			{
+				for (size_t idx{}; idx < count; ++idx) lines[idx] = planesA[idx] ^ planesB[idx];
+			});
+		runner.Run("batch   MeetPlanes", count, [&]
+			{
+				batch::MeetPlanes(planeBatchA, planeBatchB, lineBatch);
+			});
+		runner.Run("scalar  TwoBlade ^ OneBlade", count, [&]
+			{
+				for (size_t idx{}; idx < count; ++idx) points[idx] = lines[idx] ^ planesA[idx];
+			});
+		runner.Run("batch   MeetLinePlane", count, [&]
+			{
+				batch::MeetLinePlane(lineBatch, planeBatchA, pointBatch);
+			});
+	}
+
+	void BenchmarkRaycast(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Raycast");
+
+		constexpr size_t rayCount{ 4096 };
+		constexpr size_t primitivesPerType{ 8 };
+
+		RayScene scene{};
+		for (size_t idx{}; idx < primitivesPerType; ++idx)
+		{
+			scene.Add(RandomPlane());
+			scene.Add(Sphere{ RandomPoint(), 5.f + 10.f * std::fabs(RandomFloat()) });
+			scene.Add(Box{ RandomPoint(), RandomPoint() });
+		}
+
+		std::vector<Ray> rays{};
+		for (size_t idx{}; idx < rayCount; ++idx) rays.push_back(Ray::Through(RandomPoint(), RandomPoint()));
+		const RayBatch rayBatch{ rays };
+		std::vector<RayHit> hits(rayCount);
+
+		runner.Run("scalar  raycast::Cast per ray", rayCount * scene.Size(), [&]
+			{
+				for (size_t idx{}; idx < rayCount; ++idx) hits[idx] = raycast::Cast(rays[idx], scene);
+			});
+		runner.Run("batch   raycast::Cast", rayCount * scene.Size(), [&]
+			{
+				raycast::Cast(rayBatch, scene, hits);
+			});
+	}
+
+	void BenchmarkConvexOverlap(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Convex shape overlap");
+
+		constexpr size_t shapeCount{ 256 };
+
+		std::vector<ConvexShape> rectangles{}, octagons{};
+		for (size_t idx{}; idx < shapeCount; ++idx)
+		{
+			const ThreeBlade corner{ RandomPoint() };
+			rectangles.push_back(ConvexShape::Rectangle(corner[0], corner[1], 20.f + 20.f * RandomFloat(), 20.f + 20.f * RandomFloat()));
+			octagons.push_back(ConvexShape::RegularPolygon(RandomPoint(), 15.f + 10.f * RandomFloat(), 8));
+		}
+
+		size_t overlaps{};
+		runner.Run("collision::Overlap rectangle vs octagon", shapeCount * shapeCount, [&]
+			{
+				overlaps = 0;
+				for (const ConvexShape& rectangle : rectangles)
+				{
+					for (const ConvexShape& octagon : octagons) overlaps += collision::Overlap(rectangle, octagon).overlap;
+				}
+			});
+		std::printf("overlapping pairs: %zu of %zu\n", overlaps, shapeCount * shapeCount);
+	}
+
+	void BenchmarkSkinning(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Motor blend skinning");
+
+		constexpr size_t pointCount{ 16384 };
+		constexpr size_t motorCount{ 32 };
+		constexpr size_t influences{ 4 };
+
+		std::vector<Motor> motors{};
+		for (size_t idx{}; idx < motorCount; ++idx) motors.push_back(RandomMotor());
+
+		std::vector<ThreeBlade> bindPoints{};
+		SkinWeights weights{ influences };
+		weights.Reserve(pointCount);
+		for (size_t idx{}; idx < pointCount; ++idx)
+		{
+			bindPoints.push_back(RandomPoint());
+			int indices[influences]{};
+			float pointWeights[influences]{};
+			float total{};
+			for (size_t influence{}; influence < influences; ++influence)
+			{
+				indices[influence] = static_cast<int>(g_Random() % motorCount);
+				pointWeights[influence] = std::fabs(RandomFloat()) + 0.01f;
+				total += pointWeights[influence];
+			}
+			for (float& weight : pointWeights) weight /= total;
+			weights.PushBack(indices, pointWeights);
+		}
+		const PointBatch bindBatch{ bindPoints };
+
+		std::vector<ThreeBlade> skinned(pointCount);
+		PointBatch skinnedBatch{};
+		runner.Run("scalar  Blend + (M * P * ~M).Grade3()", pointCount, [&]
+			{
+				for (size_t idx{}; idx < pointCount; ++idx)
+				{
+					Motor pointMotors[influences]{};
+					for (size_t influence{}; influence < influences; ++influence)
+					{
+						pointMotors[influence] = motors[weights.Indices()[idx * influences + influence]];
+					}
+					const Motor motor{ skinning::Blend(pointMotors, weights.Weights() + idx * influences, influences) };
+					skinned[idx] = (motor * bindPoints[idx] * ~motor).Grade3();
+				}
+			});
+		runner.Run("batch   skinning::SkinPoints", pointCount, [&]
+			{
+				skinning::SkinPoints(bindBatch, weights, motors, skinnedBatch);
+			});
+
+		float maxError{};
+		for (size_t idx{}; idx < pointCount; ++idx)
+		{
+			for (size_t component{}; component < 4; ++component)
+			{
+				maxError = std::max(maxError, std::fabs(skinned[idx][component] - skinnedBatch.Get(idx)[component]));
+			}
+		}
+		std::printf("max difference SkinPoints vs operators: %g\n", maxError);
+	}
+
+	void BenchmarkMotorEstimation(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Motor estimation from correspondences");
+
+		constexpr size_t pairCount{ 4096 };
+		constexpr size_t fitCount{ 256 };
+		constexpr size_t pairsPerFit{ pairCount / fitCount };
+
+		std::vector<Motor> motors{};
+		std::vector<ThreeBlade> from{}, to{};
+		std::vector<size_t> offsets{ 0 };
+		for (size_t fit{}; fit < fitCount; ++fit)
+		{
+			motors.push_back(RandomMotor());
+			for (size_t pair{}; pair < pairsPerFit; ++pair)
+			{
+				from.push_back(RandomPoint());
+				to.push_back((motors.back() * from.back() * ~motors.back()).Grade3());
+			}
+			offsets.push_back(from.size());
+		}
+		const PointBatch fromBatch{ from }, toBatch{ to };
+
+		Motor fitted{};
+		runner.Run("scalar  MotorFitter::Add per pair", pairCount, [&]
+			{
+				MotorFitter fitter{};
+				for (size_t pair{}; pair < pairCount; ++pair) fitter.Add(from[pair], to[pair]);
+				fitted = fitter.Solve();
+			});
+		runner.Run("batch   estimation::FitMotor", pairCount, [&]
+			{
+				fitted = estimation::FitMotor(fromBatch, toBatch);
+			});
+
+		std::vector<Motor> fits{};
+		runner.Run("batch   estimation::FitMotors (16 pairs per fit)", fitCount, [&]
+			{
+				estimation::FitMotors(fromBatch, toBatch, offsets, fits);
+			});
+
+		float maxError{};
+		for (size_t fit{}; fit < fitCount; ++fit)
+		{
+			for (size_t pair{ offsets[fit] }; pair < offsets[fit + 1]; ++pair)
+			{
+				const ThreeBlade mapped{ (fits[fit] * from[pair] * ~fits[fit]).Grade3() };
+				for (size_t component{}; component < 3; ++component)
+				{
+					maxError = std::max(maxError, std::fabs(mapped[component] - to[pair][component]));
+				}
+			}
+		}
+		std::printf("max residual of the batched fits: %g\n", maxError);
+	}
+
+	void BenchmarkJacobians(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Gauss-Newton with sandwich Jacobians");
+
+		constexpr size_t pairCount{ 4096 };
+		const Motor target{ RandomMotor() };
+		std::vector<ThreeBlade> from{}, to{};
+		for (size_t pair{}; pair < pairCount; ++pair)
+		{
+			from.push_back(RandomPoint());
+			to.push_back((target * from.back() * ~target).Grade3());
+		}
+		const PointBatch fromBatch{ from }, toBatch{ to };
+		const Motor start{ skinning::Renormalize(Motor{ 1, 0.05f, -0.03f, 0.02f, 0.04f, 0.02f, -0.05f, 0 } * target) };
+
+		//what an optimization loop did before: one extra sandwich per parameter per point
+		NormalEquations differences{};
+		runner.Run("scalar  finite differences per pair", pairCount, [&]
+			{
+				differences.Clear();
+				constexpr float h{ 1e-3f };
+				for (size_t pair{}; pair < pairCount; ++pair)
+				{
+					const ThreeBlade moved{ (start * from[pair] * ~start).Grade3() };
+					const float residual[3]{ moved[0] - to[pair][0], moved[1] - to[pair][1], moved[2] - to[pair][2] };
+					float derivative[3][6]{};
+					for (size_t parameter{}; parameter < 6; ++parameter)
+					{
+						Motor delta{ 1, 0, 0, 0, 0, 0, 0, 0 };
+						delta[1 + parameter] = h;
+						const Motor nudged{ delta * start };
+						const ThreeBlade shifted{ (nudged * from[pair] * ~nudged).Grade3() };
+						for (size_t axis{}; axis < 3; ++axis) derivative[axis][parameter] = (shifted[axis] - moved[axis]) / h;
+					}
+					for (size_t row{}; row < 6; ++row)
+					{
+						for (size_t axis{}; axis < 3; ++axis)
+						{
+							for (size_t column{}; column < 6; ++column) differences.hessian[row][column] += derivative[axis][row] * derivative[axis][column];
+							differences.gradient[row] += derivative[axis][row] * residual[axis];
+						}
+					}
+				}
+			});
+
+		NormalEquations analytic{};
+		runner.Run("batch   jacobian::AccumulatePointToPoint", pairCount, [&]
+			{
+				analytic.Clear();
+				jacobian::AccumulatePointToPoint(start, fromBatch, toBatch, analytic);
+			});
+
+		Motor fitted{ start };
+		for (int iteration{}; iteration < 4; ++iteration) fitted = jacobian::GaussNewtonStep(fitted, fromBatch, toBatch);
+		float maxError{};
+		for (size_t pair{}; pair < pairCount; ++pair)
+		{
+			const ThreeBlade mapped{ (fitted * from[pair] * ~fitted).Grade3() };
+			for (size_t component{}; component < 3; ++component)
+			{
+				maxError = std::max(maxError, std::fabs(mapped[component] - to[pair][component]));
+			}
+		}
+		std::printf("max residual after 4 Gauss-Newton steps: %g\n", maxError);
+	}
+
+	void BenchmarkSweptBounds(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Swept bounds under screw motions");
+
+		constexpr size_t objectCount{ 1024 };
+		constexpr size_t sampleCount{ 32 };
+		std::vector<ScrewMotion> motions{};
+		std::vector<Box> boxes{};
+		for (size_t object{}; object < objectCount; ++object)
+		{
+			motions.push_back(ScrewMotion::Between(skinning::Renormalize(RandomMotor()), skinning::Renormalize(RandomMotor())));
+			const ThreeBlade corner{ RandomPoint() };
+			boxes.push_back(Box{ corner, ThreeBlade{ corner[0] + 1, corner[1] + 2, corner[2] + 0.5f } });
+		}
+
+		//the alternative without the helix solve: sample the trajectory and hope nothing pokes out in between
+		std::vector<Box> sampled(objectCount);
+		runner.Run("scalar  32 sampled motors per box", objectCount, [&]
+			{
+				for (size_t object{}; object < objectCount; ++object)
+				{
+					constexpr float far{ std::numeric_limits<float>::max() };
+					Box bounds{ ThreeBlade{ far, far, far }, ThreeBlade{ -far, -far, -far } };
+					for (size_t sample{}; sample < sampleCount; ++sample)
+					{
+						const Motor motor{ motions[object].At(static_cast<float>(sample) / (sampleCount - 1)) };
+						for (int corner{}; corner < 8; ++corner)
+						{
+							const ThreeBlade point{ skinning::Transform(motor, ThreeBlade{
+								(corner & 1) ? boxes[object].max[0] : boxes[object].min[0],
+								(corner & 2) ? boxes[object].max[1] : boxes[object].min[1],
+								(corner & 4) ? boxes[object].max[2] : boxes[object].min[2] }) };
+							for (size_t axis{}; axis < 3; ++axis)
+							{
+								bounds.min[axis] = std::min(bounds.min[axis], point[axis]);
+								bounds.max[axis] = std::max(bounds.max[axis], point[axis]);
+							}
+						}
+					}
+					sampled[object] = bounds;
+				}
+			});
+
+		std::vector<Box> swept{};
+		runner.Run("batch   sweep::SweptBounds boxes", objectCount, [&]
+			{
+				sweep::SweptBounds(motions, boxes, 0, 1, swept);
+			});
+
+		//positive where sampling cut a corner the exact bounds keep
+		float missed{};
+		for (size_t object{}; object < objectCount; ++object)
+		{
+			for (size_t axis{}; axis < 3; ++axis)
+			{
+				missed = std::max(missed, sampled[object].min[axis] - swept[object].min[axis]);
+				missed = std::max(missed, swept[object].max[axis] - sampled[object].max[axis]);
+			}
+		}
+		std::printf("largest extent 32 samples miss: %g\n", missed);
+	}
+
+	void BenchmarkReductions(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Point batch reductions");
+
+		constexpr size_t pointCount{ 1 << 20 };
+		std::vector<ThreeBlade> points{};
+		points.reserve(pointCount);
+		for (size_t point{}; point < pointCount; ++point) points.push_back(RandomPoint());
+		const PointBatch batch{ points };
+
+		//kept on the heap so the clobber after every call keeps the sum alive
+		std::vector<float> sum(4);
+		runner.Run("scalar  summed ThreeBlades per point", pointCount, [&]
+			{
+				std::fill(sum.begin(), sum.end(), 0.f);
+				for (const ThreeBlade& point : points)
+				{
+					for (size_t component{}; component < 4; ++component) sum[component] += point[component];
+				}
+			});
+
+		ThreeBlade centroid{};
+		runner.Run("batch   reduction::Centroid, 1 thread", pointCount, [&]
+			{
+				centroid = reduction::Centroid(batch, 1);
+			});
+		runner.Run("batch   reduction::Centroid, all threads", pointCount, [&]
+			{
+				centroid = reduction::Centroid(batch);
+			});
+
+		Box bounds{};
+		runner.Run("batch   reduction::Bounds, all threads", pointCount, [&]
+			{
+				bounds = reduction::Bounds(batch);
+			});
+
+		PointMoments moments{};
+		runner.Run("batch   reduction::Moments, 1 thread", pointCount, [&]
+			{
+				moments = reduction::Moments(batch, 1);
+			});
+		runner.Run("batch   reduction::Moments, all threads", pointCount, [&]
+			{
+				moments = reduction::Moments(batch);
+			});
+
+		//the leaves and the order they are added in do not depend on the thread count
+		bool identical{ true };
+		for (const unsigned threads : { 2u, 3u, 8u })
+		{
+			const PointMoments other{ reduction::Moments(batch, threads) };
+			const PointMoments single{ reduction::Moments(batch, 1) };
+			identical = identical && other.weight == single.weight;
+			for (size_t row{}; row < 3; ++row)
+			{
+				identical = identical && other.centroid[row] == single.centroid[row];
+				for (size_t column{}; column < 3; ++column) identical = identical && other.covariance[row][column] == single.covariance[row][column];
+			}
+		}
+		std::printf("moments identical for 1, 2, 3 and 8 threads: %s\n", identical ? "yes" : "no");
+	}
+
+	void BenchmarkElementText(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Element text formatting and parsing");
+
+		constexpr size_t motorCount{ 4096 };
+		std::vector<Motor> motors{};
+		for (size_t motor{}; motor < motorCount; ++motor) motors.push_back(RandomMotor());
+
+		size_t characters{};
+		runner.Run("scalar  Motor::toString", motorCount, [&]
+			{
+				for (const Motor& motor : motors) characters += motor.toString().size();
+			});
+
+		//one shared buffer, every motor written after the previous one like a trajectory log
+		std::vector<char> buffer(motorCount * text::MaxLength(8));
+		std::vector<char*> ends(motorCount);
+		runner.Run("batch   text::Format into one buffer", motorCount, [&]
+			{
+				char* first{ buffer.data() };
+				char* const last{ buffer.data() + buffer.size() };
+				for (size_t motor{}; motor < motorCount; ++motor)
+				{
+					first = text::Format(first, last, motors[motor]);
+					ends[motor] = first;
+					*first++ = '\n';
+				}
+			});
+
+		std::vector<Motor> parsed(motorCount);
+		runner.Run("batch   text::Parse from one buffer", motorCount, [&]
+			{
+				const char* first{ buffer.data() };
+				for (size_t motor{}; motor < motorCount; ++motor)
+				{
+					first = text::Parse(first, static_cast<const char*>(ends[motor]), parsed[motor]) + 1;
+				}
+			});
+
+		size_t mismatches{};
+		for (size_t motor{}; motor < motorCount; ++motor)
+		{
+			for (size_t component{}; component < 8; ++component)
+			{
+				const float expected{ std::fabs(motors[motor][component]) > text::g_ZeroThreshold ? motors[motor][component] : 0.f };
+				mismatches += parsed[motor][component] != expected;
+			}
+		}
+		std::printf("components that did not read back exactly: %zu\n", mismatches);
+	}
+
+	void BenchmarkBatchFiles(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Binary batch files");
+
+		constexpr size_t pointCount{ 1 << 20 };
+		std::vector<ThreeBlade> points{};
+		points.reserve(pointCount);
+		for (size_t point{}; point < pointCount; ++point) points.push_back(RandomPoint());
+		const PointBatch batch{ points };
+
+		const std::string path{ (std::filesystem::temp_directory_path() / "GEOABenchmark.ffbf").string() };
+		if (!batchfile::Write(path, batch))
+		{
+			std::printf("could not write %s\n", path.c_str());
+			return;
+		}
+
+		//the text baseline: the same points written one per line and parsed back
+		std::vector<char> lines(pointCount * text::MaxLength(4));
+		char* textLast{ lines.data() };
+		for (const ThreeBlade& point : points)
+		{
+			textLast = text::Format(textLast, lines.data() + lines.size(), point);
+			*textLast++ = '\n';
+		}
+
+		PointBatch loaded{};
+		runner.Run("text    text::Parse into a PointBatch", pointCount, [&]
+			{
+				loaded.Clear();
+				const char* first{ lines.data() };
+				ThreeBlade point{};
+				while (first != textLast)
+				{
+					first = text::Parse(first, static_cast<const char*>(textLast), point) + 1;
+					loaded.PushBack(point);
+				}
+			});
+
+		runner.Run("file    batchfile::Read into a PointBatch", pointCount, [&]
+			{
+				batchfile::Read(path, loaded);
+			});
+
+		runner.Run("file    MappedFile::Open and View", pointCount, [&]
+			{
+				batchfile::MappedFile file{};
+				file.Open(path);
+				file.View(loaded);
+			});
+
+		ThreeBlade centroid{};
+		runner.Run("memory  reduction::Centroid, 1 thread", pointCount, [&]
+			{
+				centroid = reduction::Centroid(batch, 1);
+			});
+
+		ThreeBlade mappedCentroid{};
+		runner.Run("file    Open, View and reduction::Centroid", pointCount, [&]
+			{
+				batchfile::MappedFile file{};
+				file.Open(path);
+				file.View(loaded);
+				mappedCentroid = reduction::Centroid(loaded, 1);
+			});
+
+		std::printf("centroid of the mapped file matches the one in memory: %s\n", mappedCentroid == centroid ? "yes" : "no");
+		std::remove(path.c_str());
+	}
+
+	void BenchmarkDeduplication(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Point and line deduplication");
+
+		//every source point shows up about four times, the copies less than the tolerance apart
+		constexpr float tolerance{ 1e-3f };
+		constexpr size_t pointCount{ 1 << 18 };
+		std::vector<ThreeBlade> sources{};
+		for (size_t point{}; point < pointCount / 4; ++point) sources.push_back(RandomPoint());
+		PointBatch points{};
+		LineBatch lines{};
+		for (size_t point{}; point < pointCount; ++point)
+		{
+			const ThreeBlade& source{ sources[g_Random() % sources.size()] };
+			const float offset{ tolerance / 2 };
+			const ThreeBlade copy{ source[0] + RandomFloat() * offset, source[1] + RandomFloat() * offset, source[2] + RandomFloat() * offset };
+			points.PushBack(copy);
+			lines.PushBack((source & ThreeBlade{ 0, 0, 0 }).Normalized() * (1 + std::fabs(RandomFloat())));
+		}
+
+		//pairwise RoundedEqual against the unique ones so far, on a slice small enough to finish
+		constexpr size_t pairwiseCount{ 1 << 13 };
+		std::vector<ThreeBlade> pairwiseUnique{};
+		runner.Run("scalar  RoundedEqual pairwise, 8k points", pairwiseCount, [&]
+			{
+				pairwiseUnique.clear();
+				for (size_t idx{}; idx < pairwiseCount; ++idx)
+				{
+					const ThreeBlade point{ points.Get(idx) };
+					const bool seen{ std::any_of(pairwiseUnique.begin(), pairwiseUnique.end(),
+						[&](const ThreeBlade& unique) { return unique.RoundedEqual(point, tolerance); }) };
+					if (!seen) pairwiseUnique.push_back(point);
+				}
+			});
+
+		PointBatch uniquePoints{};
+		std::vector<uint32_t> remap{};
+		runner.Run("hash    dedup::Deduplicate, 8k points", pairwiseCount, [&]
+			{
+				const PointBatch slice{ PointBatch::View(points.Component(0), pairwiseCount, points.Stride()) };
+				dedup::Deduplicate(slice, tolerance, uniquePoints, remap);
+			});
+		const size_t sliceUnique{ uniquePoints.Size() };
+
+		runner.Run("hash    dedup::Deduplicate, 256k points", pointCount, [&]
+			{
+				dedup::Deduplicate(points, tolerance, uniquePoints, remap);
+			});
+		LineBatch uniqueLines{};
+		runner.Run("hash    dedup::Deduplicate, 256k lines", pointCount, [&]
+			{
+				dedup::Deduplicate(lines, tolerance, uniqueLines, remap);
+			});
+
+		std::printf("8k slice: %zu unique pairwise, %zu hashed; 256k: %zu unique points, %zu unique lines of %zu sources\n",
+			pairwiseUnique.size(), sliceUnique, uniquePoints.Size(), uniqueLines.Size(), sources.size());
+
+		//diagonal lines tie on their largest component, the two copies pick opposite signs for their keys
+		LineHashSet diagonal{ 0.01f };
+		diagonal.Insert(TwoBlade{ 0, 0, 0, 0.7071f, -0.70715f, 0 });
+		const int diagonalMatch{ diagonal.Find(TwoBlade{ 0, 0, 0, 0.70715f, -0.7071f, 0 }) };
+		std::printf("diagonal line near a sign tie: %s\n", diagonalMatch == 0 ? "matched" : "MISSED");
+
+		//a tolerance of 0 merges exact copies only, every source twice and -0 next to 0
+		PointBatch exact{};
+		for (const ThreeBlade& source : sources)
+		{
+			exact.PushBack(source);
+			exact.PushBack(source);
+		}
+		exact.PushBack(ThreeBlade{ 0, 0, 0 });
+		exact.PushBack(ThreeBlade{ -0.f, 0, 0 });
+		dedup::Deduplicate(exact, 0, uniquePoints, remap);
+		std::printf("exact dedup, tolerance 0: %zu unique of %zu, expected %zu\n", uniquePoints.Size(), exact.Size(), sources.size() + 1);
+	}
+	void BenchmarkMotorChain(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Motor chains, one factor replaced per frame");
+
+		constexpr size_t pointCount{ 16384 };
+		std::vector<ThreeBlade> pointList{};
+		for (size_t idx{}; idx < pointCount; ++idx) pointList.push_back(RandomPoint());
+		const PointBatch points{ pointList };
+		PointBatch out{};
+
+		for (const size_t factorCount : { size_t{ 16 }, size_t{ 256 } })
+		{
+			std::vector<Motor> factors{};
+			for (size_t idx{}; idx < factorCount; ++idx) factors.push_back(RandomMotor());
+			const std::vector<Motor> replacements{ RandomElements<Motor>() };
+			const std::string suffix{ ", " + std::to_string(factorCount) + " factors" };
+
+			size_t frame{};
+			std::vector<Motor> total(1);
+			runner.Run("scalar  replace + recompose" + suffix, 1, [&]
+				{
+					factors[frame % factorCount] = replacements[frame % replacements.size()];
+					++frame;
+					total[0] = Motor{ 1, 0, 0, 0, 0, 0, 0, 0 };
+					for (const Motor& factor : factors) total[0] = total[0] * factor;
+				});
+
+			MotorChain chain{ factors };
+			runner.Run("chain   MotorChain::Set" + suffix, 1, [&]
+				{
+					chain.Set(frame % factorCount, replacements[frame % replacements.size()]);
+					++frame;
+				});
+			runner.Run("chain   Set + Apply per point" + suffix, pointCount, [&]
+				{
+					chain.Set(frame % factorCount, replacements[frame % replacements.size()]);
+					++frame;
+					chain.Apply(points, out);
+				});
+		}
+	}
+
+	void BenchmarkSceneGraph(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Scene graph propagation");
+
+		//pillars with satellites with moons, a few hundred thousand items in all
+		constexpr size_t rootCount{ 1024 };
+		constexpr size_t childCount{ 16 };
+		SceneGraph scene{};
+		std::vector<Motor> locals{};
+		std::vector<uint32_t> parents{};
+		const auto add = [&](uint32_t parent)
+			{
+				locals.push_back(RandomMotor());
+				parents.push_back(parent);
+				return scene.Add(locals.back(), parent);
+			};
+		for (size_t root{}; root < rootCount; ++root)
+		{
+			const uint32_t pillar{ add(SceneGraph::NoParent) };
+			for (size_t satellite{}; satellite < childCount; ++satellite)
+			{
+				const uint32_t orbiter{ add(pillar) };
+				for (size_t moon{}; moon < childCount; ++moon) add(orbiter);
+			}
+		}
+		const size_t nodeCount{ locals.size() };
+		scene.Update();
+
+		std::vector<Motor> worlds(nodeCount);
+		runner.Run("scalar  recompose every node", nodeCount, [&]
+			{
+				for (size_t node{}; node < nodeCount; ++node)
+				{
+					worlds[node] = parents[node] == SceneGraph::NoParent ? locals[node] : worlds[parents[node]] * locals[node];
+				}
+			});
+
+		//one pillar in a hundred moves per frame, its satellites and moons follow
+		size_t frame{};
+		runner.Run("scene   Update, 1% of the pillars moved", nodeCount, [&]
+			{
+				for (size_t root{ frame++ % 100 }; root < rootCount; root += 100)
+				{
+					const uint32_t pillar{ static_cast<uint32_t>(root * (1 + childCount * (1 + childCount))) };
+					scene.SetLocal(pillar, locals[pillar]);
+				}
+				scene.Update();
+			});
+		runner.Run("scene   Update, every pillar moved", nodeCount, [&]
+			{
+				for (uint32_t node{}; node < nodeCount; node += 1 + childCount * (1 + childCount)) scene.SetLocal(node, locals[node]);
+				scene.Update(0);
+			});
+	}
+
+	void BenchmarkAnimation(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Motor animation tracks");
+
+		constexpr size_t trackCount{ 4096 };
+		constexpr size_t keyCount{ 64 };
+		constexpr float frameTime{ 1.f / 60 };
+		for (const Interpolation interpolation : { Interpolation::ScrewLinear, Interpolation::Spline })
+		{
+			std::vector<MotorTrack> tracks(trackCount, MotorTrack{ interpolation });
+			for (MotorTrack& track : tracks)
+			{
+				track.Reserve(keyCount);
+				for (size_t key{}; key < keyCount; ++key) track.AddKey(key * 0.25f + std::fabs(RandomFloat()) * 0.2f, RandomMotor());
+			}
+			const std::string suffix{ interpolation == Interpolation::ScrewLinear ? ", screw" : ", spline" };
+
+			//the clock runs through the tracks and starts over, like a looping animation
+			const float duration{ keyCount * 0.25f };
+			float time{};
+			std::vector<Motor> sampled(trackCount);
+			runner.Run("search  MotorTrack::Sample(time)" + suffix, trackCount, [&]
+				{
+					time = std::fmod(time + frameTime, duration);
+					for (size_t idx{}; idx < trackCount; ++idx) sampled[idx] = tracks[idx].Sample(time);
+				});
+			std::vector<size_t> cursors{};
+			MotorBatch out{};
+			runner.Run("cursor  animation::SampleTracks" + suffix, trackCount, [&]
+				{
+					time = std::fmod(time + frameTime, duration);
+					animation::SampleTracks(tracks, time, cursors, out);
+				});
+		}
+
+		//evenly spaced collinear keys, Catmull-Rom reproduces a straight line at constant speed exactly
+		const TwoBlade xAxis{ 1, 0, 0, 0, 0, 0 };
+		MotorTrack line{ Interpolation::Spline };
+		for (size_t key{}; key < 4; ++key) line.AddKey(static_cast<float>(key), Motor::Translation(static_cast<float>(key), xAxis));
+		float worstError{};
+		for (const float sampleTime : { 0.25f, 0.5f, 1.25f, 1.75f, 2.5f })
+		{
+			const ThreeBlade moved{ skinning::Transform(line.Sample(sampleTime), ThreeBlade{ 0, 0, 0, 1 }) };
+			worstError = std::max(worstError, std::fabs(moved[0] / moved[3] - sampleTime));
+		}
+		std::printf("spline through collinear keys stays linear: %s (worst error %g)\n", worstError < 1e-4f ? "yes" : "no", worstError);
+	}
+
+	void BenchmarkCompactMotor(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Compact motor encoding");
+
+		constexpr size_t motorCount{ 100000 };
+		MotorBatch motors{};
+		motors.Reserve(motorCount);
+		for (size_t idx{}; idx < motorCount; ++idx)
+		{
+			//rigid, and within the 128 units the encodings below cover
+			const TwoBlade direction{ RandomFloat(), RandomFloat(), RandomFloat(), 0, 0, 0 };
+			const TwoBlade axis{ 0, 0, 0, RandomFloat(), RandomFloat(), RandomFloat() };
+			motors.PushBack(Motor::Translation(RandomFloat() * 100, direction) * Motor::Rotation(RandomFloat() * 180, axis));
+		}
+
+		for (const MotorEncoding encoding : { MotorEncoding{ 8, 12, 128 }, MotorEncoding{ 12, 16, 128 }, MotorEncoding{ 16, 20, 128 } })
+		{
+			const std::string suffix{ ", " + std::to_string(encoding.rotationBits) + "/" + std::to_string(encoding.translationBits) + " bits" };
+			std::vector<uint8_t> data{};
+			runner.Run("batch   compact::Encode" + suffix, motorCount, [&]
+				{
+					compact::Encode(motors, encoding, data);
+				});
+			MotorBatch decoded{};
+			runner.Run("batch   compact::Decode" + suffix, motorCount, [&]
+				{
+					compact::Decode(data, motorCount, encoding, decoded);
+				});
+
+			//the rotor may come back negated, which is the same motor
+			float rotorError{};
+			float translationError{};
+			for (size_t idx{}; idx < motorCount; ++idx)
+			{
+				const Motor original{ motors.Get(idx) };
+				const Motor roundTrip{ decoded.Get(idx) };
+				const float dot{ original[0] * roundTrip[0] + original[4] * roundTrip[4] + original[5] * roundTrip[5] + original[6] * roundTrip[6] };
+				const float sign{ dot < 0 ? -1.f : 1.f };
+				for (const size_t component : { 0, 4, 5, 6 }) rotorError = std::max(rotorError, std::fabs(original[component] - sign * roundTrip[component]));
+				for (const size_t component : { 1, 2, 3, 7 }) translationError = std::max(translationError, std::fabs(original[component] - sign * roundTrip[component]));
+			}
+			std::printf("%.2f bytes per motor (32 as floats), worst rotor component error %.2e, translation part %.2e\n",
+				static_cast<double>(data.size()) / motorCount, rotorError, translationError);
+		}
+	}
+
+	void BenchmarkProjection(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Projection and rejection");
+
+		constexpr size_t count{ 4096 };
+		std::vector<ThreeBlade> points{};
+		std::vector<TwoBlade> lines{};
+		std::vector<OneBlade> planes{};
+		for (size_t idx{}; idx < count; ++idx)
+		{
+			points.push_back(RandomPoint());
+			lines.push_back(RandomPoint() & RandomPoint());
+			planes.push_back(RandomPlane());
+		}
+		const PointBatch pointBatch{ points };
+		const LineBatch lineBatch{ lines };
+		const PlaneBatch planeBatch{ planes };
+		const ThreeBlade point{ RandomPoint() };
+		const TwoBlade line{ RandomPoint() & RandomPoint() };
+		const OneBlade plane{ RandomPlane() };
+
+		std::vector<ThreeBlade> projectedPoints(count);
+		std::vector<TwoBlade> projectedLines(count);
+		std::vector<OneBlade> projectedPlanes(count);
+		PointBatch outPoints{};
+		LineBatch outLines{};
+		PlaneBatch outPlanes{};
+
+		runner.Run("scalar  ((p | L) * ~L).Grade3()", count, [&]
+			{
+				for (size_t idx{}; idx < count; ++idx) projectedPoints[idx] = ((points[idx] | line) * ~line).Grade3();
+			});
+		runner.Run("scalar  projection::Project(point, line)", count, [&]
+			{
+				for (size_t idx{}; idx < count; ++idx) projectedPoints[idx] = projection::Project(points[idx], line);
+			});
+		runner.Run("batch   projection::Project(points, line)", count, [&]
+			{
+				projection::Project(pointBatch, line, outPoints);
+			});
+		runner.Run("scalar  ((p | P) * ~P).Grade3()", count, [&]
+			{
+				for (size_t idx{}; idx < count; ++idx) projectedPoints[idx] = ((points[idx] | plane) * ~plane).Grade3();
+			});
+		runner.Run("batch   projection::Project(points, plane)", count, [&]
+			{
+				projection::Project(pointBatch, plane, outPoints);
+			});
+		runner.Run("batch   projection::Reject(points, plane)", count, [&]
+			{
+				projection::Reject(pointBatch, plane, outPoints);
+			});
+		runner.Run("scalar  ((L | P) * ~P).Grade2()", count, [&]
+			{
+				for (size_t idx{}; idx < count; ++idx) projectedLines[idx] = ((lines[idx] | plane) * ~plane).Grade2();
+			});
+		runner.Run("batch   projection::Project(lines, plane)", count, [&]
+			{
+				projection::Project(lineBatch, plane, outLines);
+			});
+		runner.Run("scalar  ((P | p) * ~p).Grade1()", count, [&]
+			{
+				for (size_t idx{}; idx < count; ++idx) projectedPlanes[idx] = ((planes[idx] | point) * ~point).Grade1();
+			});
+		runner.Run("batch   projection::Project(planes, point)", count, [&]
+			{
+				projection::Project(planeBatch, point, outPlanes);
+			});
+	}
+
+	void BenchmarkInverseKinematics(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Inverse kinematics");
+
+		constexpr size_t chainCount{ 4096 };
+		constexpr size_t jointCount{ 8 };
+		IKChains chains{ chainCount, jointCount };
+		std::vector<std::vector<ThreeBlade>> scalarChains{};
+		std::vector<std::vector<float>> scalarLengths{};
+		PointBatch targets{};
+		for (size_t chain{}; chain < chainCount; ++chain)
+		{
+			//hanging down from an anchor, the targets all around it and some out of reach
+			std::vector<ThreeBlade> joints{};
+			const ThreeBlade anchor{ RandomPoint() };
+			for (size_t joint{}; joint < jointCount; ++joint) joints.push_back(ThreeBlade{ anchor[0], anchor[1] - joint * 2.f, anchor[2] });
+			chains.SetChain(chain, joints);
+			scalarChains.push_back(joints);
+			scalarLengths.push_back(std::vector<float>(jointCount - 1, 2.f));
+			targets.PushBack(ThreeBlade{ anchor[0] + RandomFloat() * 12, anchor[1] + RandomFloat() * 12, anchor[2] + RandomFloat() * 12 });
+		}
+		const IKChains start{ chains };
+		const ik::SolveSettings settings{ 10, 1e-3f };
+
+		//the same sweeps one chain at a time on points, as a per-item solver would run them
+		runner.Run("scalar  FABRIK per chain, 10 sweeps", chainCount, [&]
+			{
+				for (size_t chain{}; chain < chainCount; ++chain)
+				{
+					std::vector<ThreeBlade>& joints{ scalarChains[chain] };
+					const ThreeBlade anchor{ joints[0] };
+					const ThreeBlade target{ targets.Get(chain) };
+					for (size_t sweep{}; sweep < settings.maxIterations; ++sweep)
+					{
+						joints.back() = target;
+						for (size_t joint{ jointCount - 1 }; joint-- > 0;)
+						{
+							ThreeBlade offset{ joints[joint] - joints[joint + 1] };
+							offset *= scalarLengths[chain][joint] / offset.VNorm();
+							joints[joint] = joints[joint + 1] + offset;
+						}
+						joints[0] = anchor;
+						for (size_t joint{ 1 }; joint < jointCount; ++joint)
+						{
+							ThreeBlade offset{ joints[joint] - joints[joint - 1] };
+							offset *= scalarLengths[chain][joint - 1] / offset.VNorm();
+							joints[joint] = joints[joint - 1] + offset;
+						}
+					}
+				}
+			});
+		size_t sweeps{};
+		runner.Run("batch   ik::Solve, 4096 chains of 8 joints", chainCount, [&]
+			{
+				chains = start;
+				sweeps = ik::Solve(chains, targets, settings);
+			});
+		MotorBatch motors{};
+		runner.Run("batch   ik::SegmentMotors", chainCount * (jointCount - 1), [&]
+			{
+				ik::SegmentMotors(chains, motors);
+			});
+		std::printf("ik::Solve used %zu of %zu sweeps\n", sweeps, settings.maxIterations);
+	}
+
+	void BenchmarkDynamics(BenchmarkRunner& runner)
+	{
+		runner.PrintHeader("Rigid body integration");
+
+		constexpr size_t bodyCount{ 100000 };
+		constexpr float dt{ 1.f / 60 };
+		RigidBodies bodies{};
+		bodies.Reserve(bodyCount);
+		std::vector<Motor> poses{};
+		std::vector<TwoBlade> velocities{};
+		for (size_t idx{}; idx < bodyCount; ++idx)
+		{
+			const float linear[3]{ RandomFloat(), RandomFloat(), RandomFloat() };
+			const float angular[3]{ RandomFloat(), RandomFloat(), RandomFloat() };
+			const Inertia inertia{ Inertia::Box(1 + std::fabs(RandomFloat()), 0.5f, 1 + std::fabs(RandomFloat()), 0.25f) };
+			bodies.Add(RandomMotor(), dynamics::BodyVelocity(linear, angular), inertia);
+			poses.push_back(bodies.Poses().Get(idx));
+			velocities.push_back(bodies.Velocities().Get(idx));
+		}
+		const RigidBodies start{ bodies };
+
+		//kinematics only, the velocities stay as they are
+		runner.Run("scalar  M = (M * (1 + dt * B)).Normalized()", bodyCount, [&]
+			{
+				for (size_t idx{}; idx < bodyCount; ++idx)
+				{
+					const TwoBlade& b{ velocities[idx] };
+					const Motor step{ 1, dt * b[0], dt * b[1], dt * b[2], dt * b[3], dt * b[4], dt * b[5], 0 };
+					poses[idx] = (poses[idx] * step).Normalized();
+				}
+			});
+
+		dynamics::StepSettings settings{};
+		settings.gravity[1] = -9.81f;
+		runner.Run("batch   dynamics::StepSemiImplicit, 100k bodies", bodyCount, [&]
+			{
+				dynamics::StepSemiImplicit(bodies, dt, settings);
+			});
+		runner.Run("batch   dynamics::StepRungeKutta4, 100k bodies", bodyCount, [&]
+			{
+				dynamics::StepRungeKutta4(bodies, dt, settings);
+			});
+
+		//a second of free tumbling: the energy is conserved exactly, so any change is integration error
+		const auto drift = [&](void (*step)(RigidBodies&, float, const dynamics::StepSettings&, const LineBatch*))
+			{
+				bodies = start;
+				for (size_t frame{}; frame < 60; ++frame) step(bodies, dt, dynamics::StepSettings{}, nullptr);
+				double worst{};
+				for (size_t idx{}; idx < bodyCount; ++idx)
+				{
+					const Inertia inertia{ start.Inertias().Get(idx) };
+					const double before{ dynamics::KineticEnergy(inertia, start.Velocities().Get(idx)) };
+					const double after{ dynamics::KineticEnergy(inertia, bodies.Velocities().Get(idx)) };
+					worst = std::max(worst, std::fabs(after - before) / before);
+				}
+				return worst;
+			};
+		const double semiImplicitDrift{ drift(dynamics::StepSemiImplicit) };
+		const double rungeKuttaDrift{ drift(dynamics::StepRungeKutta4) };
+		std::printf("worst relative energy change after 60 free steps: semi-implicit %.2e, RK4 %.2e\n", semiImplicitDrift, rungeKuttaDrift);
+	}
+}
+
+// GEOABenchmark [--json path] [--counters] [section...]
+// Runs the sections whose name contains one of the given words, all of them without any, and writes
+// every result to path as JSON when asked so runs can be compared over time.
+// --counters adds cycles, instructions, IPC, cache and branch misses per operation where perf_event allows.
+int main(int argc, char** argv)
+{
+	const std::pair<const char*, void (*)(BenchmarkRunner&)> sections[]{
+		{ "generated", BenchmarkGeneratedAlgebra },
+		{ "operators", BenchmarkFlyFishOperators },
+		{ "patterns", BenchmarkGamePatterns },
+		{ "distances", BenchmarkBatchDistances },
+		{ "joinmeet", BenchmarkBatchJoinMeet },
+		{ "raycast", BenchmarkRaycast },
+		{ "convex", BenchmarkConvexOverlap },
+		{ "skinning", BenchmarkSkinning },
+		{ "estimation", BenchmarkMotorEstimation },
+		{ "jacobians", BenchmarkJacobians },
+		{ "swept", BenchmarkSweptBounds },
+		{ "reductions", BenchmarkReductions },
+		{ "text", BenchmarkElementText },
+		{ "files", BenchmarkBatchFiles },
+		{ "dedup", BenchmarkDeduplication },
+		{ "dynamics", BenchmarkDynamics },
+		{ "chain", BenchmarkMotorChain },
+		{ "scene", BenchmarkSceneGraph },
+		{ "animation", BenchmarkAnimation },
+		{ "compact", BenchmarkCompactMotor },
+		{ "projection", BenchmarkProjection },
+		{ "ik", BenchmarkInverseKinematics } };
+
+	std::string jsonPath{};
+	std::vector<std::string> filters{};
+	bool counters{ false };
+	for (int idx{ 1 }; idx < argc; ++idx)
+	{
+		if (std::string{ argv[idx] } == "--json" && idx + 1 < argc) jsonPath = argv[++idx];
+		else if (std::string{ argv[idx] } == "--counters") counters = true;
+		else filters.push_back(argv[idx]);
+	}
+
+	BenchmarkRunner runner{};
+	if (counters) runner.EnableCounters();
+	for (const auto& [name, run] : sections)
+	{
+		const bool selected{ filters.empty() || std::any_of(filters.begin(), filters.end(),
+			[name = name](const std::string& filter) { return std::string{ name }.find(filter) != std::string::npos; }) };
+		if (selected) run(runner);
+	}
+
+	if (!jsonPath.empty() && !runner.WriteJson(jsonPath))
+	{
+		std::printf("could not write %s\n", jsonPath.c_str());
+		return 1;
+	}
+	return 0;
+}
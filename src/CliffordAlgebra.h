@@ -0,0 +1,463 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Compile-time generated Clifford algebra R(P,Q,R).
+// Basis vectors are ordered degenerate first, then positive, then negative, so R(3,0,1) gives
+// e0 (e0*e0 = 0) followed by e1, e2, e3. A basis blade is the bitmask of the vectors it contains,
+// and every product table is evaluated by the compiler: an element product expands into one
+// multiply-add per non-zero term, the same straight-line code as the hand-written FlyFish kernels.
+
+template <int P, int Q, int R>
+struct CliffordAlgebra;
+
+template <typename Algebra, unsigned Grades>
+class CliffordElement;
+
+enum class CliffordProduct
+{
+    Geometric,
+    Outer,
+    Inner,
+    Regressive
+};
+
+template <int P, int Q, int R>
+struct CliffordAlgebra
+{
+    static_assert(P >= 0 && Q >= 0 && R >= 0, "Signature must be non-negative");
+    static_assert(P + Q + R > 0 && P + Q + R <= 6, "Only small algebras (up to 6 basis vectors) are supported");
+
+    static constexpr int Dimension{ P + Q + R };
+    static constexpr unsigned BladeCount{ 1u << Dimension };
+    static constexpr unsigned Pseudoscalar{ BladeCount - 1 };
+
+    [[nodiscard]] static constexpr int Metric(int vector)
+    {
+        if (vector < R) return 0;
+        if (vector < R + P) return 1;
+        return -1;
+    }
+
+    [[nodiscard]] static constexpr int Grade(unsigned blade)
+    {
+        int grade{};
+        for (; blade; blade &= blade - 1) ++grade;
+        return grade;
+    }
+
+    // Sign of bringing the vectors of blade a * blade b into canonical (ascending) order
+    [[nodiscard]] static constexpr int ReorderSign(unsigned a, unsigned b)
+    {
+        int swaps{};
+        for (a >>= 1; a; a >>= 1)
+        {
+            swaps += Grade(a & b);
+        }
+        return (swaps & 1) ? -1 : 1;
+    }
+
+    [[nodiscard]] static constexpr int GeometricSign(unsigned a, unsigned b)
+    {
+        int sign{ ReorderSign(a, b) };
+        for (int vector{}; vector < Dimension; ++vector)
+        {
+            if ((a & b) & (1u << vector)) sign *= Metric(vector);
+        }
+        return sign;
+    }
+
+    // Sign such that blade ^ (sign * complement) == pseudoscalar
+    [[nodiscard]] static constexpr int ComplementSign(unsigned blade)
+    {
+        return ReorderSign(blade, Pseudoscalar ^ blade);
+    }
+
+    [[nodiscard]] static constexpr int ReverseSign(unsigned blade)
+    {
+        const int grade{ Grade(blade) };
+        return ((grade * (grade - 1) / 2) & 1) ? -1 : 1;
+    }
+
+    // Sign of the blade product for the requested product, 0 when the term vanishes.
+    // The resulting blade is written to result.
+    [[nodiscard]] static constexpr int ProductSign(CliffordProduct product, unsigned a, unsigned b, unsigned& result)
+    {
+        switch (product)
+        {
+        case CliffordProduct::Geometric:
+            result = a ^ b;
+            return GeometricSign(a, b);
+        case CliffordProduct::Outer:
+            result = a ^ b;
+            return (a & b) ? 0 : ReorderSign(a, b);
+        case CliffordProduct::Inner:
+        {
+            result = a ^ b;
+            const int gradeDifference{ Grade(a) - Grade(b) };
+            const int expected{ gradeDifference < 0 ? -gradeDifference : gradeDifference };
+            return Grade(result) == expected ? GeometricSign(a, b) : 0;
+        }
+        case CliffordProduct::Regressive:
+        {
+            // complement both, take the outer product and undo the complement
+            const unsigned ca{ Pseudoscalar ^ a };
+            const unsigned cb{ Pseudoscalar ^ b };
+            if (ca & cb) return 0;
+            result = Pseudoscalar ^ (ca ^ cb);
+            return ComplementSign(a) * ComplementSign(b) * ReorderSign(ca, cb) * ComplementSign(result);
+        }
+        }
+        return 0;
+    }
+
+    [[nodiscard]] static constexpr unsigned GradeBit(int grade)
+    {
+        return 1u << grade;
+    }
+
+    [[nodiscard]] static std::string BladeName(unsigned blade)
+    {
+        if (blade == 0) return "";
+        std::string name{ "e" };
+        for (int vector{}; vector < Dimension; ++vector)
+        {
+            if (blade & (1u << vector)) name += std::to_string(vector + (R == 0 ? 1 : 0));
+        }
+        return name;
+    }
+
+    template <unsigned Grades>
+    using Element = CliffordElement<CliffordAlgebra, Grades>;
+
+    using Scalar = Element<GradeBit(0)>;
+    using Vector = Element<GradeBit(1)>;
+    using Bivector = Element<GradeBit(2)>;
+    using Trivector = Element<GradeBit(3)>;
+    using Even = Element<0x55555555u & ((2u << Dimension) - 1)>;
+    using Odd = Element<0xAAAAAAAAu & ((2u << Dimension) - 1)>;
+    using Full = Element<(2u << Dimension) - 1>;
+};
+
+// Plane based geometric algebra of the plane and of space, and the conformal model of space
+using PGA2D = CliffordAlgebra<2, 0, 1>;
+using PGA3D = CliffordAlgebra<3, 0, 1>;
+using CGA3D = CliffordAlgebra<4, 1, 0>;
+
+namespace clifford
+{
+    template <typename Algebra>
+    [[nodiscard]] constexpr size_t BladeCount(unsigned grades)
+    {
+        size_t count{};
+        for (unsigned blade{}; blade < Algebra::BladeCount; ++blade)
+        {
+            if (grades & (1u << Algebra::Grade(blade))) ++count;
+        }
+        return count;
+    }
+
+    // Blades ordered by grade, then by bitmask
+    template <typename Algebra, unsigned Grades>
+    [[nodiscard]] constexpr auto BladeList()
+    {
+        std::array<unsigned, BladeCount<Algebra>(Grades)> blades{};
+        size_t idx{};
+        for (int grade{}; grade <= Algebra::Dimension; ++grade)
+        {
+            if (!(Grades & (1u << grade))) continue;
+            for (unsigned blade{}; blade < Algebra::BladeCount; ++blade)
+            {
+                if (Algebra::Grade(blade) == grade) blades[idx++] = blade;
+            }
+        }
+        return blades;
+    }
+
+    // Grades that actually receive a non-zero term from the product of two elements
+    template <typename Algebra, CliffordProduct Product, unsigned GradesA, unsigned GradesB>
+    [[nodiscard]] constexpr unsigned ProductGrades()
+    {
+        unsigned grades{};
+        for (unsigned a : BladeList<Algebra, GradesA>())
+        {
+            for (unsigned b : BladeList<Algebra, GradesB>())
+            {
+                unsigned result{};
+                if (Algebra::ProductSign(Product, a, b, result) != 0) grades |= 1u << Algebra::Grade(result);
+            }
+        }
+        return grades;
+    }
+
+    struct ProductTerm
+    {
+        unsigned char a;
+        unsigned char b;
+        unsigned char result;
+        signed char sign;
+        bool first;
+    };
+
+    template <typename Algebra, CliffordProduct Product, unsigned GradesA, unsigned GradesB, unsigned GradesResult>
+    [[nodiscard]] constexpr size_t ProductTermCount()
+    {
+        size_t count{};
+        for (unsigned a : BladeList<Algebra, GradesA>())
+        {
+            for (unsigned b : BladeList<Algebra, GradesB>())
+            {
+                unsigned result{};
+                if (Algebra::ProductSign(Product, a, b, result) != 0
+                    && (GradesResult & (1u << Algebra::Grade(result)))) ++count;
+            }
+        }
+        return count;
+    }
+
+    // All non-zero terms, grouped per result coefficient so the first term can be assigned
+    template <typename Algebra, CliffordProduct Product, unsigned GradesA, unsigned GradesB, unsigned GradesResult>
+    [[nodiscard]] constexpr auto ProductTermList()
+    {
+        constexpr auto bladesA{ BladeList<Algebra, GradesA>() };
+        constexpr auto bladesB{ BladeList<Algebra, GradesB>() };
+        constexpr auto bladesResult{ BladeList<Algebra, GradesResult>() };
+
+        std::array<ProductTerm, ProductTermCount<Algebra, Product, GradesA, GradesB, GradesResult>()> terms{};
+        size_t count{};
+        for (size_t r{}; r < bladesResult.size(); ++r)
+        {
+            bool first{ true };
+            for (size_t a{}; a < bladesA.size(); ++a)
+            {
+                for (size_t b{}; b < bladesB.size(); ++b)
+                {
+                    unsigned result{};
+                    const int sign{ Algebra::ProductSign(Product, bladesA[a], bladesB[b], result) };
+                    if (sign == 0 || result != bladesResult[r]) continue;
+
+                    terms[count++] = ProductTerm{
+                        static_cast<unsigned char>(a),
+                        static_cast<unsigned char>(b),
+                        static_cast<unsigned char>(r),
+                        static_cast<signed char>(sign),
+                        first };
+                    first = false;
+                }
+            }
+        }
+        return terms;
+    }
+
+    template <typename Algebra, CliffordProduct Product, unsigned GradesA, unsigned GradesB, unsigned GradesResult>
+    inline constexpr auto ProductTerms{ ProductTermList<Algebra, Product, GradesA, GradesB, GradesResult>() };
+
+    template <const auto& Terms, size_t Idx, typename Result, typename A, typename B>
+    inline void AccumulateTerm(Result& res, const A& a, const B& b)
+    {
+        constexpr ProductTerm term{ Terms[Idx] };
+        const float value{ a[term.a] * b[term.b] };
+        if constexpr (term.first)
+        {
+            if constexpr (term.sign > 0) res[term.result] = value;
+            else res[term.result] = -value;
+        }
+        else
+        {
+            if constexpr (term.sign > 0) res[term.result] += value;
+            else res[term.result] -= value;
+        }
+    }
+
+    template <CliffordProduct Product, unsigned GradesResult, typename Algebra, unsigned GradesA, unsigned GradesB>
+    [[nodiscard]] inline CliffordElement<Algebra, GradesResult> Multiply(const CliffordElement<Algebra, GradesA>& a, const CliffordElement<Algebra, GradesB>& b)
+    {
+        constexpr const auto& terms{ ProductTerms<Algebra, Product, GradesA, GradesB, GradesResult> };
+        CliffordElement<Algebra, GradesResult> res{};
+        [&]<size_t... Idx>(std::index_sequence<Idx...>)
+        {
+            (AccumulateTerm<ProductTerms<Algebra, Product, GradesA, GradesB, GradesResult>, Idx>(res, a, b), ...);
+        }(std::make_index_sequence<terms.size()>{});
+        return res;
+    }
+}
+
+template <typename Algebra, unsigned Grades>
+class CliffordElement
+{
+public:
+    static constexpr auto Blades{ clifford::BladeList<Algebra, Grades>() };
+    static constexpr size_t Size{ Blades.size() };
+
+    [[nodiscard]] CliffordElement() noexcept
+    {
+    }
+
+    template <typename... Coefficients>
+        requires (sizeof...(Coefficients) == Size && (std::is_arithmetic_v<Coefficients> && ...))
+    [[nodiscard]] CliffordElement(Coefficients... coefficients) noexcept
+        : data{ static_cast<float>(coefficients)... }
+    {
+    }
+
+    inline float& operator [] (size_t idx) { return data[idx]; }
+    inline const float& operator [] (size_t idx) const { return data[idx]; }
+
+    // Index of a basis blade (bitmask) in this element, -1 when the element does not hold it
+    [[nodiscard]] static constexpr int IndexOf(unsigned blade)
+    {
+        for (size_t idx{}; idx < Size; ++idx)
+        {
+            if (Blades[idx] == blade) return static_cast<int>(idx);
+        }
+        return -1;
+    }
+
+    auto begin() { return data.begin(); }
+    auto end() { return data.end(); }
+    auto begin() const { return data.begin(); }
+    auto end() const { return data.end(); }
+
+    [[nodiscard]] std::string toString() const
+    {
+        std::string output{};
+        for (size_t idx{}; idx < Size; ++idx)
+        {
+            if (data[idx] == 0) continue;
+            if (!output.empty()) output += " + ";
+            output += std::to_string(data[idx]);
+            if (Blades[idx] != 0) output += "*" + Algebra::BladeName(Blades[idx]);
+        }
+        return output.empty() ? "0" : output;
+    }
+
+    CliffordElement& operator += (const CliffordElement& b)
+    {
+        for (size_t idx{}; idx < Size; ++idx) data[idx] += b[idx];
+        return *this;
+    }
+    CliffordElement& operator -= (const CliffordElement& b)
+    {
+        for (size_t idx{}; idx < Size; ++idx) data[idx] -= b[idx];
+        return *this;
+    }
+    CliffordElement& operator *= (float s)
+    {
+        for (size_t idx{}; idx < Size; ++idx) data[idx] *= s;
+        return *this;
+    }
+
+    [[nodiscard]] CliffordElement operator + (const CliffordElement& b) const
+    {
+        CliffordElement res{ *this };
+        return res += b;
+    }
+    [[nodiscard]] CliffordElement operator - (const CliffordElement& b) const
+    {
+        CliffordElement res{ *this };
+        return res -= b;
+    }
+    [[nodiscard]] CliffordElement operator * (float s) const
+    {
+        CliffordElement res{ *this };
+        return res *= s;
+    }
+    [[nodiscard]] friend CliffordElement operator * (float s, const CliffordElement& element)
+    {
+        return element * s;
+    }
+    [[nodiscard]] CliffordElement operator - () const
+    {
+        return *this * -1.f;
+    }
+
+    // Reverse
+    [[nodiscard]] CliffordElement operator ~ () const
+    {
+        CliffordElement res{};
+        for (size_t idx{}; idx < Size; ++idx)
+        {
+            res[idx] = Algebra::ReverseSign(Blades[idx]) * data[idx];
+        }
+        return res;
+    }
+
+    // Right complement dual
+    [[nodiscard]] auto operator ! () const
+    {
+        constexpr unsigned dualGrades{ DualGrades() };
+        CliffordElement<Algebra, dualGrades> res{};
+        for (size_t idx{}; idx < Size; ++idx)
+        {
+            const unsigned blade{ Blades[idx] };
+            res[CliffordElement<Algebra, dualGrades>::IndexOf(Algebra::Pseudoscalar ^ blade)] = Algebra::ComplementSign(blade) * data[idx];
+        }
+        return res;
+    }
+
+    // Projection onto the grades in Mask, blades missing from this element read as zero
+    template <unsigned Mask>
+    [[nodiscard]] CliffordElement<Algebra, Mask> Grade() const
+    {
+        CliffordElement<Algebra, Mask> res{};
+        for (size_t idx{}; idx < res.Size; ++idx)
+        {
+            const int source{ IndexOf(res.Blades[idx]) };
+            if (source >= 0) res[idx] = data[source];
+        }
+        return res;
+    }
+
+private:
+    std::array<float, Size> data{};
+
+    [[nodiscard]] static constexpr unsigned DualGrades()
+    {
+        unsigned grades{};
+        for (int grade{}; grade <= Algebra::Dimension; ++grade)
+        {
+            if (Grades & (1u << grade)) grades |= 1u << (Algebra::Dimension - grade);
+        }
+        return grades;
+    }
+};
+
+template <typename Algebra, unsigned GradesA, unsigned GradesB>
+[[nodiscard]] inline auto operator * (const CliffordElement<Algebra, GradesA>& a, const CliffordElement<Algebra, GradesB>& b)
+{
+    constexpr unsigned grades{ clifford::ProductGrades<Algebra, CliffordProduct::Geometric, GradesA, GradesB>() };
+    return clifford::Multiply<CliffordProduct::Geometric, grades>(a, b);
+}
+
+template <typename Algebra, unsigned GradesA, unsigned GradesB>
+[[nodiscard]] inline auto operator ^ (const CliffordElement<Algebra, GradesA>& a, const CliffordElement<Algebra, GradesB>& b)
+{
+    constexpr unsigned grades{ clifford::ProductGrades<Algebra, CliffordProduct::Outer, GradesA, GradesB>() };
+    return clifford::Multiply<CliffordProduct::Outer, grades>(a, b);
+}
+
+template <typename Algebra, unsigned GradesA, unsigned GradesB>
+[[nodiscard]] inline auto operator | (const CliffordElement<Algebra, GradesA>& a, const CliffordElement<Algebra, GradesB>& b)
+{
+    constexpr unsigned grades{ clifford::ProductGrades<Algebra, CliffordProduct::Inner, GradesA, GradesB>() };
+    return clifford::Multiply<CliffordProduct::Inner, grades>(a, b);
+}
+
+template <typename Algebra, unsigned GradesA, unsigned GradesB>
+[[nodiscard]] inline auto operator & (const CliffordElement<Algebra, GradesA>& a, const CliffordElement<Algebra, GradesB>& b)
+{
+    constexpr unsigned grades{ clifford::ProductGrades<Algebra, CliffordProduct::Regressive, GradesA, GradesB>() };
+    return clifford::Multiply<CliffordProduct::Regressive, grades>(a, b);
+}
+
+// versor * x * ~versor restricted to the grades of x, so no unused grades are ever computed
+template <typename Algebra, unsigned GradesV, unsigned GradesX>
+[[nodiscard]] inline CliffordElement<Algebra, GradesX> Sandwich(const CliffordElement<Algebra, GradesV>& versor, const CliffordElement<Algebra, GradesX>& x)
+{
+    const auto left{ versor * x };
+    return clifford::Multiply<CliffordProduct::Geometric, GradesX>(left, ~versor);
+}
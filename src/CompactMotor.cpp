@@ -0,0 +1,239 @@
+#include "CompactMotor.h"
+
+#include <cmath>
+
+namespace
+{
+    // The three smaller components of a unit quaternion lie within +-1/sqrt(2)
+    constexpr float g_SmallestRange{ 0.70710678f };
+
+    // Per motor, in separate arrays so the quantizing loops vectorize; the packing picks the fields it needs
+    struct Fields
+    {
+        explicit Fields(size_t count)
+            : index(count), rotor{ std::vector<uint32_t>(count), std::vector<uint32_t>(count), std::vector<uint32_t>(count), std::vector<uint32_t>(count) }
+            , largest{ std::vector<float>(count), std::vector<float>(count), std::vector<float>(count), std::vector<float>(count) }
+            , translation{ std::vector<uint32_t>(count), std::vector<uint32_t>(count), std::vector<uint32_t>(count) }
+        {
+        }
+
+        // Index of the largest rotor component, as a float so the vector loop can compute it with selects
+        std::vector<float> index;
+        // All four rotor components, the largest one is skipped when packing
+        std::vector<uint32_t> rotor[4];
+        // 1 for the largest rotor component when decoding, 0 for the others
+        std::vector<float> largest[4];
+        std::vector<uint32_t> translation[3];
+    };
+
+    uint32_t Quantize(float value, float range, float steps)
+    {
+        //clamp(x, -1, 1) as (|x + 1| - |x - 1|) / 2, GCC turns min and max chains into branches that stop vectorization
+        const float unit{ (std::fabs(value / range + 1) - std::fabs(value / range - 1)) * 0.25f + 0.5f };
+        //through int32, which every SIMD level converts directly; fields are at most 24 bits
+        return static_cast<uint32_t>(static_cast<int32_t>(unit * steps + 0.5f));
+    }
+
+    float Dequantize(uint32_t value, float range, float steps)
+    {
+        return (static_cast<float>(static_cast<int32_t>(value)) / steps * 2 - 1) * range;
+    }
+
+    float Steps(unsigned bits)
+    {
+        return static_cast<float>((1u << bits) - 1);
+    }
+
+    void QuantizeMotors(const MotorBatch& motors, const MotorEncoding& encoding, Fields& fields)
+    {
+        const size_t count{ motors.Size() };
+        const float* m[8]{};
+        for (size_t component{}; component < 8; ++component) m[component] = motors.Component(component);
+        float* index{ fields.index.data() };
+        uint32_t* rotor[4]{};
+        for (size_t component{}; component < 4; ++component) rotor[component] = fields.rotor[component].data();
+        uint32_t* translation[3]{};
+        for (size_t axis{}; axis < 3; ++axis) translation[axis] = fields.translation[axis].data();
+
+        const float rotationSteps{ Steps(encoding.rotationBits) };
+        const float translationSteps{ Steps(encoding.translationBits) };
+        const float range{ encoding.translationRange };
+
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            const float norm{ 1 / std::sqrt(m[0][idx] * m[0][idx] + m[4][idx] * m[4][idx] + m[5][idx] * m[5][idx] + m[6][idx] * m[6][idx]) };
+            const float s{ m[0][idx] * norm }, r1{ m[4][idx] * norm }, r2{ m[5][idx] * norm }, r3{ m[6][idx] * norm };
+            const float t1{ m[1][idx] * norm }, t2{ m[2][idx] * norm }, t3{ m[3][idx] * norm }, q{ m[7][idx] * norm };
+
+            //M * ~R is the translator (1, -t / 2)
+            translation[0][idx] = Quantize(-2 * (s * t1 + r3 * t2 - r2 * t3 + r1 * q), range, translationSteps);
+            translation[1][idx] = Quantize(-2 * (-r3 * t1 + s * t2 + r1 * t3 + r2 * q), range, translationSteps);
+            translation[2][idx] = Quantize(-2 * (r2 * t1 - r1 * t2 + s * t3 + r3 * q), range, translationSteps);
+
+            //the largest component in two rounds of pairs, then the rotor turned so it is positive, R and -R are the same
+            const bool over01{ std::fabs(r1) > std::fabs(s) };
+            const bool over23{ std::fabs(r3) > std::fabs(r2) };
+            const float value01{ over01 ? r1 : s };
+            const float value23{ over23 ? r3 : r2 };
+            const bool over{ std::fabs(value23) > std::fabs(value01) };
+            index[idx] = over ? (over23 ? 3.f : 2.f) : (over01 ? 1.f : 0.f);
+
+            const float sign{ std::copysign(1.f, over ? value23 : value01) };
+            rotor[0][idx] = Quantize(sign * s, g_SmallestRange, rotationSteps);
+            rotor[1][idx] = Quantize(sign * r1, g_SmallestRange, rotationSteps);
+            rotor[2][idx] = Quantize(sign * r2, g_SmallestRange, rotationSteps);
+            rotor[3][idx] = Quantize(sign * r3, g_SmallestRange, rotationSteps);
+        }
+    }
+
+    void DequantizeMotors(const Fields& fields, size_t count, const MotorEncoding& encoding, MotorBatch& motors)
+    {
+        float* m[8]{};
+        for (size_t component{}; component < 8; ++component) m[component] = motors.Component(component);
+        const uint32_t* rotor[4]{};
+        const float* largest[4]{};
+        for (size_t component{}; component < 4; ++component)
+        {
+            rotor[component] = fields.rotor[component].data();
+            largest[component] = fields.largest[component].data();
+        }
+        const uint32_t* translation[3]{};
+        for (size_t axis{}; axis < 3; ++axis) translation[axis] = fields.translation[axis].data();
+
+        const float rotationSteps{ Steps(encoding.rotationBits) };
+        const float translationSteps{ Steps(encoding.translationBits) };
+        const float range{ encoding.translationRange };
+
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            //the largest component has weight 1 and is rebuilt from the unit length, the others have weight 0
+            float c[4]{};
+            float squares{};
+            for (size_t component{}; component < 4; ++component)
+            {
+                c[component] = Dequantize(rotor[component][idx], g_SmallestRange, rotationSteps) * (1 - largest[component][idx]);
+                squares += c[component] * c[component];
+            }
+            //the largest is at least 1/2, the fabs only guards against rounding
+            const float big{ std::sqrt(std::fabs(1 - squares)) };
+            const float s{ c[0] + largest[0][idx] * big };
+            const float r1{ c[1] + largest[1][idx] * big };
+            const float r2{ c[2] + largest[2][idx] * big };
+            const float r3{ c[3] + largest[3][idx] * big };
+
+            //T * R with T = (1, a), a = -t / 2
+            const float a1{ -Dequantize(translation[0][idx], range, translationSteps) / 2 };
+            const float a2{ -Dequantize(translation[1][idx], range, translationSteps) / 2 };
+            const float a3{ -Dequantize(translation[2][idx], range, translationSteps) / 2 };
+            m[0][idx] = s;
+            m[1][idx] = s * a1 - r3 * a2 + r2 * a3;
+            m[2][idx] = r3 * a1 + s * a2 - r1 * a3;
+            m[3][idx] = -r2 * a1 + r1 * a2 + s * a3;
+            m[4][idx] = r1;
+            m[5][idx] = r2;
+            m[6][idx] = r3;
+            m[7][idx] = r1 * a1 + r2 * a2 + r3 * a3;
+        }
+    }
+
+    // Least significant bit first, fields of at most 24 bits keep the accumulator under 32 bits between bytes
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(uint8_t* data) : m_Data{ data } {}
+
+        void Write(uint32_t value, unsigned bits)
+        {
+            //masked, so a NaN quantized to garbage cannot spill into the next field
+            m_Pending |= (static_cast<uint64_t>(value) & ((uint64_t{ 1 } << bits) - 1)) << m_PendingBits;
+            m_PendingBits += bits;
+            for (; m_PendingBits >= 8; m_PendingBits -= 8, m_Pending >>= 8) *m_Data++ = static_cast<uint8_t>(m_Pending);
+        }
+
+        void Flush()
+        {
+            if (m_PendingBits > 0) *m_Data = static_cast<uint8_t>(m_Pending);
+        }
+
+    private:
+        uint8_t* m_Data;
+        uint64_t m_Pending{};
+        unsigned m_PendingBits{};
+    };
+
+    class BitReader
+    {
+    public:
+        explicit BitReader(const uint8_t* data) : m_Data{ data } {}
+
+        uint32_t Read(unsigned bits)
+        {
+            for (; m_PendingBits < bits; m_PendingBits += 8) m_Pending |= static_cast<uint64_t>(*m_Data++) << m_PendingBits;
+            const uint32_t value{ static_cast<uint32_t>(m_Pending & ((uint64_t{ 1 } << bits) - 1)) };
+            m_Pending >>= bits;
+            m_PendingBits -= bits;
+            return value;
+        }
+
+    private:
+        const uint8_t* m_Data;
+        uint64_t m_Pending{};
+        unsigned m_PendingBits{};
+    };
+}
+
+namespace compact
+{
+    size_t EncodedSize(size_t count, const MotorEncoding& encoding)
+    {
+        return (count * encoding.BitsPerMotor() + 7) / 8;
+    }
+
+    bool Encode(const MotorBatch& motors, const MotorEncoding& encoding, std::vector<uint8_t>& out)
+    {
+        if (!encoding.IsValid()) return false;
+
+        const size_t count{ motors.Size() };
+        Fields fields{ count };
+        QuantizeMotors(motors, encoding, fields);
+
+        out.assign(EncodedSize(count, encoding), 0);
+        BitWriter writer{ out.data() };
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            const uint32_t largest{ static_cast<uint32_t>(fields.index[idx]) };
+            writer.Write(largest, 2);
+            for (uint32_t component{}; component < 4; ++component)
+            {
+                if (component != largest) writer.Write(fields.rotor[component][idx], encoding.rotationBits);
+            }
+            for (size_t axis{}; axis < 3; ++axis) writer.Write(fields.translation[axis][idx], encoding.translationBits);
+        }
+        writer.Flush();
+        return true;
+    }
+
+    bool Decode(const std::vector<uint8_t>& data, size_t count, const MotorEncoding& encoding, MotorBatch& out)
+    {
+        if (!encoding.IsValid() || data.size() < EncodedSize(count, encoding)) return false;
+
+        Fields fields{ count };
+        BitReader reader{ data.data() };
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            const uint32_t largest{ reader.Read(2) };
+            for (uint32_t component{}; component < 4; ++component)
+            {
+                fields.largest[component][idx] = component == largest ? 1.f : 0.f;
+                if (component != largest) fields.rotor[component][idx] = reader.Read(encoding.rotationBits);
+            }
+            for (size_t axis{}; axis < 3; ++axis) fields.translation[axis][idx] = reader.Read(encoding.translationBits);
+        }
+
+        out.Resize(count);
+        DequantizeMotors(fields, count, encoding, out);
+        return true;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Bit budget of a compact motor. The rotor is a unit quaternion, stored as its three smallest components
+// plus the 2 bit index of the largest one, which is rebuilt from the unit length. The translation is quantized
+// per axis over [-translationRange, translationRange]. The e0123 part follows from both, rigid motors need no more.
+struct MotorEncoding
+{
+    // Per smallest component, 2 to 23
+    unsigned rotationBits{ 12 };
+    // Per axis, 1 to 24
+    unsigned translationBits{ 16 };
+    float translationRange{ 1024 };
+
+    [[nodiscard]] size_t BitsPerMotor() const { return 2 + 3 * rotationBits + 3 * translationBits; }
+    [[nodiscard]] bool IsValid() const
+    {
+        return rotationBits >= 2 && rotationBits <= 23 && translationBits >= 1 && translationBits <= 24 && translationRange > 0;
+    }
+};
+
+// Motors packed back to back, BitsPerMotor() bits each, least significant bit first.
+// Quantizing runs on the component arrays in one vectorized pass, only the bit packing is scalar.
+// Translations outside the range are clamped to it, motors are expected to be rigid (see skinning::Renormalize).
+namespace compact
+{
+    [[nodiscard]] size_t EncodedSize(size_t count, const MotorEncoding& encoding);
+
+    // out is resized to EncodedSize(motors.Size(), encoding), false and out untouched for an invalid encoding
+    bool Encode(const MotorBatch& motors, const MotorEncoding& encoding, std::vector<uint8_t>& out);
+    // Reads count motors, false when data is shorter than EncodedSize or the encoding is invalid
+    bool Decode(const std::vector<uint8_t>& data, size_t count, const MotorEncoding& encoding, MotorBatch& out);
+}
@@ -0,0 +1,122 @@
+#include "ConvexShape.h"
+
+#include <algorithm>
+#include <cmath>
+
+ConvexShape ConvexShape::Polygon(const std::vector<ThreeBlade>& vertices)
+{
+    ConvexShape shape{};
+    if (vertices.empty()) return shape;
+
+    float centerX{}, centerY{};
+    for (const ThreeBlade& vertex : vertices)
+    {
+        const ThreeBlade flat{ vertex[0] / vertex[3], vertex[1] / vertex[3], 0 };
+        shape.m_Vertices.PushBack(flat);
+        centerX += flat[0];
+        centerY += flat[1];
+    }
+    const ThreeBlade center{ centerX / vertices.size(), centerY / vertices.size(), 0 };
+
+    //every edge joined with the z direction gives the face plane standing on it
+    const ThreeBlade up{ 0, 0, 1, 0 };
+    const size_t count{ shape.m_Vertices.Size() };
+    for (size_t idx{}; idx < count && count > 1; ++idx)
+    {
+        const ThreeBlade from{ shape.m_Vertices.Get(idx) };
+        const ThreeBlade to{ shape.m_Vertices.Get((idx + 1) % count) };
+        OneBlade face{ (up & (from & to)).Normalized() };
+        if ((face & center) > 0) face = -face;
+        shape.m_Planes.PushBack(face);
+    }
+    return shape;
+}
+
+ConvexShape ConvexShape::Rectangle(float left, float bottom, float width, float height)
+{
+    return Polygon({
+        ThreeBlade{ left, bottom, 0 },
+        ThreeBlade{ left + width, bottom, 0 },
+        ThreeBlade{ left + width, bottom + height, 0 },
+        ThreeBlade{ left, bottom + height, 0 } });
+}
+
+ConvexShape ConvexShape::RegularPolygon(const ThreeBlade& center, float radius, int sides)
+{
+    constexpr float twoPi{ 6.28318530718f };
+
+    std::vector<ThreeBlade> vertices{};
+    for (int side{}; side < sides; ++side)
+    {
+        const float angle{ twoPi * side / sides };
+        vertices.emplace_back(center[0] / center[3] + radius * std::cos(angle), center[1] / center[3] + radius * std::sin(angle), 0.f);
+    }
+    return Polygon(vertices);
+}
+
+ConvexShape ConvexShape::Transformed(const Motor& motor) const
+{
+    ConvexShape shape{};
+    //planes are carried through their normal direction and foot point, the point sandwich is the one FlyFish gets right
+    for (size_t idx{}; idx < m_Planes.Size(); ++idx)
+    {
+        const OneBlade plane{ m_Planes.Get(idx).Normalized() };
+        const ThreeBlade foot{ (motor * ThreeBlade{ -plane[0] * plane[1], -plane[0] * plane[2], -plane[0] * plane[3] } * ~motor).Grade3() };
+        const ThreeBlade normal{ (motor * ThreeBlade{ plane[1], plane[2], plane[3], 0 } * ~motor).Grade3() };
+        const float offset{ (normal[0] * foot[0] + normal[1] * foot[1] + normal[2] * foot[2]) / foot[3] };
+        shape.m_Planes.PushBack(OneBlade{ -offset, normal[0], normal[1], normal[2] });
+    }
+    for (size_t idx{}; idx < m_Vertices.Size(); ++idx)
+    {
+        shape.m_Vertices.PushBack((motor * m_Vertices.Get(idx) * ~motor).Grade3());
+    }
+    return shape;
+}
+
+bool ConvexShape::Contains(const ThreeBlade& point) const
+{
+    for (size_t idx{}; idx < m_Planes.Size(); ++idx)
+    {
+        if ((m_Planes.Get(idx) & point) / point[3] > 0) return false;
+    }
+    return !m_Planes.Empty();
+}
+
+namespace collision
+{
+    Contact Overlap(const ConvexShape& a, const ConvexShape& b)
+    {
+        const size_t planeCountA{ a.Planes().Size() };
+        const size_t planeCountB{ b.Planes().Size() };
+        if (planeCountA == 0 || planeCountB == 0) return Contact{};
+
+        //how far the other shape sticks out in front of every face, both ways round.
+        //Game shapes have a handful of faces, so the scratch space only hits the heap for big ones.
+        constexpr size_t localCount{ 64 };
+        float local[localCount];
+        std::vector<float> heap{};
+        float* separations{ local };
+        if (planeCountA + planeCountB > localCount)
+        {
+            heap.resize(planeCountA + planeCountB);
+            separations = heap.data();
+        }
+
+        batch::PointPlaneSeparations(b.Vertices(), a.Planes(), separations);
+        if (*std::max_element(separations, separations + planeCountA) >= 0) return Contact{};
+        batch::PointPlaneSeparations(a.Vertices(), b.Planes(), separations + planeCountA);
+
+        const float* axis{ std::max_element(separations, separations + planeCountA + planeCountB) };
+        if (*axis >= 0) return Contact{};
+
+        const size_t face{ static_cast<size_t>(axis - separations) };
+        Contact contact{};
+        contact.overlap = true;
+        contact.depth = -*axis;
+        //faces of b point away from b, flip them so the normal always runs from a to b
+        contact.normal = face < planeCountA
+            ? a.Planes().Get(face).Normalized()
+            : -b.Planes().Get(face - planeCountA).Normalized();
+        return contact;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// A convex shape as the intersection of half-spaces. Every OneBlade face plane points outward,
+// so a point is inside when plane & point <= 0 for all of them.
+// The vertices are kept alongside for the separating axis test.
+class ConvexShape
+{
+public:
+    ConvexShape() = default;
+
+    // Convex polygon in the z = 0 plane, vertices in either winding order. The z coordinate of the input is dropped.
+    [[nodiscard]] static ConvexShape Polygon(const std::vector<ThreeBlade>& vertices);
+    [[nodiscard]] static ConvexShape Rectangle(float left, float bottom, float width, float height);
+    [[nodiscard]] static ConvexShape RegularPolygon(const ThreeBlade& center, float radius, int sides);
+
+    // The shape moved by motor, faces and vertices alike (M X ~M)
+    [[nodiscard]] ConvexShape Transformed(const Motor& motor) const;
+
+    [[nodiscard]] bool Contains(const ThreeBlade& point) const;
+
+    [[nodiscard]] const PlaneBatch& Planes() const { return m_Planes; }
+    [[nodiscard]] const PointBatch& Vertices() const { return m_Vertices; }
+
+private:
+    PlaneBatch m_Planes{};
+    PointBatch m_Vertices{};
+};
+
+struct Contact
+{
+    bool overlap{};
+    // Face plane of the separating axis with the least overlap, its normal points from the first shape to the second
+    OneBlade normal{};
+    // How far the second shape has to move along normal to stop overlapping
+    float depth{};
+};
+
+namespace collision
+{
+    // Separating axis test over the face planes of both shapes. Exact for polygons in a common plane,
+    // conservative for solids where an edge-edge axis could still separate them.
+    [[nodiscard]] Contact Overlap(const ConvexShape& a, const ConvexShape& b);
+}
@@ -0,0 +1,280 @@
+#include "Dynamics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Pose (s, t1, t2, t3, r1, r2, r3, q) and body velocity (b0 .. b5) of one body, in FlyFish component order
+    struct BodyState
+    {
+        float m[8];
+        float b[6];
+    };
+
+    struct BodyParameters
+    {
+        float inverseMass;
+        float moments[3];
+        float inverseMoments[3];
+        float force[3];
+        float torque[3];
+    };
+
+    // dM/dt = M * B
+    inline void PoseRate(const BodyState& y, BodyState& rate)
+    {
+        const float s{ y.m[0] }, t1{ y.m[1] }, t2{ y.m[2] }, t3{ y.m[3] }, r1{ y.m[4] }, r2{ y.m[5] }, r3{ y.m[6] }, q{ y.m[7] };
+        const float b0{ y.b[0] }, b1{ y.b[1] }, b2{ y.b[2] }, b3{ y.b[3] }, b4{ y.b[4] }, b5{ y.b[5] };
+
+        rate.m[0] = -(r1 * b3 + r2 * b4 + r3 * b5);
+        rate.m[1] = s * b0 - t2 * b5 + t3 * b4 - r2 * b2 + r3 * b1 - q * b3;
+        rate.m[2] = s * b1 + t1 * b5 - t3 * b3 + r1 * b2 - r3 * b0 - q * b4;
+        rate.m[3] = s * b2 - t1 * b4 + t2 * b3 - r1 * b1 + r2 * b0 - q * b5;
+        rate.m[4] = s * b3 - r2 * b5 + r3 * b4;
+        rate.m[5] = s * b4 + r1 * b5 - r3 * b3;
+        rate.m[6] = s * b5 - r1 * b4 + r2 * b3;
+        rate.m[7] = t1 * b3 + t2 * b4 + t3 * b5 + r1 * b0 + r2 * b1 + r3 * b2;
+    }
+
+    // dB/dt from the Euler equations in the body frame:
+    //   I dw/dt = (I w) x w + torque        dv/dt = v x w + force / m + gravity
+    inline void VelocityRate(const BodyState& y, const BodyParameters& body, const dynamics::StepSettings& settings, BodyState& rate)
+    {
+        const float s{ y.m[0] }, r1{ y.m[4] }, r2{ y.m[5] }, r3{ y.m[6] };
+        const float b0{ y.b[0] }, b1{ y.b[1] }, b2{ y.b[2] }, b3{ y.b[3] }, b4{ y.b[4] }, b5{ y.b[5] };
+
+        const float w[3]{ -2 * b3, -2 * b4, -2 * b5 };
+        const float v[3]{ -2 * b0, -2 * b1, -2 * b2 };
+
+        //gravity into the body frame: the rotor is the quaternion (s, -r1, -r2, -r3), apply its transpose
+        const float x{ -r1 }, yq{ -r2 }, z{ -r3 };
+        const float* g{ settings.gravity };
+        const float gravity[3]{
+            (1 - 2 * (yq * yq + z * z)) * g[0] + 2 * (x * yq + s * z) * g[1] + 2 * (x * z - s * yq) * g[2],
+            2 * (x * yq - s * z) * g[0] + (1 - 2 * (x * x + z * z)) * g[1] + 2 * (yq * z + s * x) * g[2],
+            2 * (x * z + s * yq) * g[0] + 2 * (yq * z - s * x) * g[1] + (1 - 2 * (x * x + yq * yq)) * g[2] };
+
+        const float momentum[3]{ body.moments[0] * w[0], body.moments[1] * w[1], body.moments[2] * w[2] };
+        const float angular[3]{
+            (momentum[1] * w[2] - momentum[2] * w[1] + body.torque[0]) * body.inverseMoments[0] - settings.angularDamping * w[0],
+            (momentum[2] * w[0] - momentum[0] * w[2] + body.torque[1]) * body.inverseMoments[1] - settings.angularDamping * w[1],
+            (momentum[0] * w[1] - momentum[1] * w[0] + body.torque[2]) * body.inverseMoments[2] - settings.angularDamping * w[2] };
+        const float linear[3]{
+            v[1] * w[2] - v[2] * w[1] + body.force[0] * body.inverseMass + gravity[0] - settings.linearDamping * v[0],
+            v[2] * w[0] - v[0] * w[2] + body.force[1] * body.inverseMass + gravity[1] - settings.linearDamping * v[1],
+            v[0] * w[1] - v[1] * w[0] + body.force[2] * body.inverseMass + gravity[2] - settings.linearDamping * v[2] };
+
+        for (size_t axis{}; axis < 3; ++axis)
+        {
+            rate.b[axis] = -0.5f * linear[axis];
+            rate.b[axis + 3] = -0.5f * angular[axis];
+        }
+    }
+
+    inline void Derivative(const BodyState& y, const BodyParameters& body, const dynamics::StepSettings& settings, BodyState& rate)
+    {
+        PoseRate(y, rate);
+        VelocityRate(y, body, settings, rate);
+    }
+
+    // Unit rotor and no e0123 left once the translation is taken out, see skinning::Renormalize
+    inline void Renormalize(float* m)
+    {
+        const float a{ 1 / std::sqrt(m[0] * m[0] + m[4] * m[4] + m[5] * m[5] + m[6] * m[6]) };
+        const float b{ a * a * a * (m[0] * m[7] - (m[1] * m[4] + m[2] * m[5] + m[3] * m[6])) };
+        const float s{ m[0] };
+        for (size_t axis{ 1 }; axis < 4; ++axis) m[axis] = m[axis] * a + m[axis + 3] * b;
+        for (size_t axis{ 4 }; axis < 7; ++axis) m[axis] *= a;
+        m[0] = s * a;
+        m[7] = m[7] * a - s * b;
+    }
+
+    // Component pointers of the batches, gathered once per step
+    struct BodyArrays
+    {
+        float* m[8];
+        float* b[6];
+        const float* inertia[4];
+        const float* forque[6];
+    };
+
+    BodyArrays Arrays(RigidBodies& bodies, const LineBatch* forques)
+    {
+        BodyArrays arrays{};
+        for (size_t component{}; component < 8; ++component) arrays.m[component] = bodies.Poses().Component(component);
+        for (size_t component{}; component < 6; ++component) arrays.b[component] = bodies.Velocities().Component(component);
+        for (size_t component{}; component < 4; ++component) arrays.inertia[component] = bodies.Inertias().Component(component);
+        for (size_t component{}; component < 6; ++component) arrays.forque[component] = forques ? forques->Component(component) : nullptr;
+        return arrays;
+    }
+
+    // Bodies from 0 up to this have an entry in forques, the rest feel gravity only
+    size_t ForcedCount(const RigidBodies& bodies, const LineBatch* forques)
+    {
+        return forques ? std::min(bodies.Size(), forques->Size()) : 0;
+    }
+
+    template <bool HasForques>
+    inline void Load(const BodyArrays& arrays, size_t idx, BodyState& state, BodyParameters& body)
+    {
+        for (size_t component{}; component < 8; ++component) state.m[component] = arrays.m[component][idx];
+        for (size_t component{}; component < 6; ++component) state.b[component] = arrays.b[component][idx];
+        body.inverseMass = 1 / arrays.inertia[0][idx];
+        for (size_t axis{}; axis < 3; ++axis)
+        {
+            body.moments[axis] = arrays.inertia[axis + 1][idx];
+            body.inverseMoments[axis] = 1 / body.moments[axis];
+            body.force[axis] = HasForques ? arrays.forque[axis][idx] : 0;
+            body.torque[axis] = HasForques ? arrays.forque[axis + 3][idx] : 0;
+        }
+    }
+
+    inline void Store(const BodyArrays& arrays, size_t idx, const BodyState& state)
+    {
+        for (size_t component{}; component < 8; ++component) arrays.m[component][idx] = state.m[component];
+        for (size_t component{}; component < 6; ++component) arrays.b[component][idx] = state.b[component];
+    }
+
+    template <bool HasForques>
+    void SemiImplicit(const BodyArrays& arrays, size_t first, size_t last, float dt, const dynamics::StepSettings& settings)
+    {
+        FLYFISH_VECTORIZE
+        for (size_t idx{ first }; idx < last; ++idx)
+        {
+            BodyState state;
+            BodyParameters body;
+            Load<HasForques>(arrays, idx, state, body);
+
+            BodyState rate;
+            VelocityRate(state, body, settings, rate);
+            for (size_t component{}; component < 6; ++component) state.b[component] += dt * rate.b[component];
+
+            //the pose moves with the new velocity, which is what keeps the scheme stable
+            PoseRate(state, rate);
+            for (size_t component{}; component < 8; ++component) state.m[component] += dt * rate.m[component];
+            Renormalize(state.m);
+            Store(arrays, idx, state);
+        }
+    }
+
+    inline void Advance(const BodyState& state, const BodyState& rate, float dt, BodyState& out)
+    {
+        for (size_t component{}; component < 8; ++component) out.m[component] = state.m[component] + dt * rate.m[component];
+        for (size_t component{}; component < 6; ++component) out.b[component] = state.b[component] + dt * rate.b[component];
+    }
+
+    template <bool HasForques>
+    void RungeKutta4(const BodyArrays& arrays, size_t first, size_t last, float dt, const dynamics::StepSettings& settings)
+    {
+        FLYFISH_VECTORIZE
+        for (size_t idx{ first }; idx < last; ++idx)
+        {
+            BodyState state;
+            BodyParameters body;
+            Load<HasForques>(arrays, idx, state, body);
+
+            BodyState k1, k2, k3, k4, stage;
+            Derivative(state, body, settings, k1);
+            Advance(state, k1, dt / 2, stage);
+            Derivative(stage, body, settings, k2);
+            Advance(state, k2, dt / 2, stage);
+            Derivative(stage, body, settings, k3);
+            Advance(state, k3, dt, stage);
+            Derivative(stage, body, settings, k4);
+
+            for (size_t component{}; component < 8; ++component)
+            {
+                state.m[component] += dt / 6 * (k1.m[component] + 2 * k2.m[component] + 2 * k3.m[component] + k4.m[component]);
+            }
+            for (size_t component{}; component < 6; ++component)
+            {
+                state.b[component] += dt / 6 * (k1.b[component] + 2 * k2.b[component] + 2 * k3.b[component] + k4.b[component]);
+            }
+            Renormalize(state.m);
+            Store(arrays, idx, state);
+        }
+    }
+}
+
+Inertia Inertia::Sphere(float mass, float radius)
+{
+    const float moment{ 0.4f * mass * radius * radius };
+    return Inertia{ mass, { moment, moment, moment } };
+}
+
+Inertia Inertia::Box(float mass, float halfX, float halfY, float halfZ)
+{
+    return Inertia{ mass, {
+        mass / 3 * (halfY * halfY + halfZ * halfZ),
+        mass / 3 * (halfX * halfX + halfZ * halfZ),
+        mass / 3 * (halfX * halfX + halfY * halfY) } };
+}
+
+void RigidBodies::Reserve(size_t count)
+{
+    m_Poses.Reserve(count);
+    m_Velocities.Reserve(count);
+    m_Inertias.Reserve(count);
+}
+
+void RigidBodies::Clear()
+{
+    m_Poses.Clear();
+    m_Velocities.Clear();
+    m_Inertias.Clear();
+}
+
+size_t RigidBodies::Add(const Motor& pose, const TwoBlade& velocity, const Inertia& inertia)
+{
+    m_Poses.PushBack(pose);
+    m_Velocities.PushBack(velocity);
+    m_Inertias.PushBack(inertia);
+    return Size() - 1;
+}
+
+namespace dynamics
+{
+    TwoBlade BodyVelocity(const float linear[3], const float angular[3])
+    {
+        return TwoBlade{ -0.5f * linear[0], -0.5f * linear[1], -0.5f * linear[2], -0.5f * angular[0], -0.5f * angular[1], -0.5f * angular[2] };
+    }
+
+    TwoBlade Momentum(const Inertia& inertia, const TwoBlade& velocity)
+    {
+        TwoBlade momentum{};
+        for (size_t axis{}; axis < 3; ++axis)
+        {
+            momentum[axis] = -2 * inertia.mass * velocity[axis];
+            momentum[axis + 3] = -2 * inertia.moments[axis] * velocity[axis + 3];
+        }
+        return momentum;
+    }
+
+    float KineticEnergy(const Inertia& inertia, const TwoBlade& velocity)
+    {
+        //(m v.v + w.I w) / 2 with v = -2 b
+        float energy{};
+        for (size_t axis{}; axis < 3; ++axis)
+        {
+            energy += inertia.mass * velocity[axis] * velocity[axis] + inertia.moments[axis] * velocity[axis + 3] * velocity[axis + 3];
+        }
+        return 2 * energy;
+    }
+
+    void StepSemiImplicit(RigidBodies& bodies, float dt, const StepSettings& settings, const LineBatch* forques)
+    {
+        const BodyArrays arrays{ Arrays(bodies, forques) };
+        const size_t forced{ ForcedCount(bodies, forques) };
+        SemiImplicit<true>(arrays, 0, forced, dt, settings);
+        SemiImplicit<false>(arrays, forced, bodies.Size(), dt, settings);
+    }
+
+    void StepRungeKutta4(RigidBodies& bodies, float dt, const StepSettings& settings, const LineBatch* forques)
+    {
+        const BodyArrays arrays{ Arrays(bodies, forques) };
+        const size_t forced{ ForcedCount(bodies, forques) };
+        RungeKutta4<true>(arrays, 0, forced, dt, settings);
+        RungeKutta4<false>(arrays, forced, bodies.Size(), dt, settings);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Mass and principal moments of inertia around the body origin, the body axes being the principal axes.
+// This is the diagonal inertia map from body velocity to body momentum.
+struct Inertia
+{
+    float mass{ 1 };
+    float moments[3]{ 1, 1, 1 };
+
+    [[nodiscard]] static Inertia Sphere(float mass, float radius);
+    // Solid box with the given half extents along the body axes
+    [[nodiscard]] static Inertia Box(float mass, float halfX, float halfY, float halfZ);
+
+    // mass, then the three moments, so inertia can live in an ElementBatch
+    [[nodiscard]] float& operator[](size_t idx) { return idx == 0 ? mass : moments[idx - 1]; }
+    [[nodiscard]] const float& operator[](size_t idx) const { return idx == 0 ? mass : moments[idx - 1]; }
+};
+
+using InertiaBatch = ElementBatch<Inertia, 4>;
+
+// Rigid bodies in structure of arrays form. A body is a pose motor M, taking body coordinates to the world,
+// and a velocity bivector B in the body frame with dM/dt = M * B, so one small step is M * (1 + dt * B).
+// Like every FlyFish motor velocity B = -(v, w) / 2: v is the velocity of the body origin and w the angular
+// velocity, both in body coordinates. dynamics::BodyVelocity and the accessors below convert.
+class RigidBodies
+{
+public:
+    [[nodiscard]] size_t Size() const { return m_Poses.Size(); }
+
+    void Reserve(size_t count);
+    void Clear();
+    // Returns the index of the new body
+    size_t Add(const Motor& pose, const TwoBlade& velocity, const Inertia& inertia);
+
+    [[nodiscard]] MotorBatch& Poses() { return m_Poses; }
+    [[nodiscard]] const MotorBatch& Poses() const { return m_Poses; }
+    [[nodiscard]] LineBatch& Velocities() { return m_Velocities; }
+    [[nodiscard]] const LineBatch& Velocities() const { return m_Velocities; }
+    [[nodiscard]] InertiaBatch& Inertias() { return m_Inertias; }
+    [[nodiscard]] const InertiaBatch& Inertias() const { return m_Inertias; }
+
+private:
+    MotorBatch m_Poses{};
+    LineBatch m_Velocities{};
+    InertiaBatch m_Inertias{};
+};
+
+namespace dynamics
+{
+    struct StepSettings
+    {
+        // World space acceleration applied to every body
+        float gravity[3]{};
+        // Fraction of the linear and angular velocity lost per unit of time
+        float linearDamping{};
+        float angularDamping{};
+    };
+
+    // B for a body whose origin moves with linear and spins with angular, both in body coordinates
+    [[nodiscard]] TwoBlade BodyVelocity(const float linear[3], const float angular[3]);
+    // Body momentum (m v, I w) in the velocity layout: e01, e02, e03 linear, e23, e31, e12 angular
+    [[nodiscard]] TwoBlade Momentum(const Inertia& inertia, const TwoBlade& velocity);
+    [[nodiscard]] float KineticEnergy(const Inertia& inertia, const TwoBlade& velocity);
+
+    // Semi-implicit Euler: the velocity is advanced first, the pose then moves with the new velocity and is
+    // renormalized. forques, when given, holds a body frame force (e01, e02, e03) and torque (e23, e31, e12) per body;
+    // bodies past its end feel gravity only.
+    void StepSemiImplicit(RigidBodies& bodies, float dt, const StepSettings& settings, const LineBatch* forques = nullptr);
+    // Classic fourth order Runge-Kutta on pose and velocity, about four times the work for much smaller drift
+    void StepRungeKutta4(RigidBodies& bodies, float dt, const StepSettings& settings, const LineBatch* forques = nullptr);
+}
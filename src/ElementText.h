@@ -0,0 +1,148 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <system_error>
+
+#include "FlyFish.h"
+
+// Text in the format of GAElement::toString, e.g. "-2*e01 + e02 - 0.5*e123", without streams or allocations.
+// Coefficients are written with std::to_chars, the shortest text that reads back to the same float,
+// so Parse(Format(element)) gives the element back exactly (up to the components toString drops as zero).
+namespace text
+{
+    // Components with a magnitude up to this are left out, as toString does
+    constexpr float g_ZeroThreshold{ 1e-6f };
+
+    // Enough room for any element with componentCount components
+    constexpr size_t MaxLength(size_t componentCount)
+    {
+        //" - " + the longest shortest-float "-1.17549435e-38" + "*" + "e0123"
+        return componentCount * 24 + 1;
+    }
+
+    namespace detail
+    {
+        inline char* Append(char* first, char* last, const char* text)
+        {
+            const size_t length{ std::strlen(text) };
+            if (first == nullptr || static_cast<size_t>(last - first) < length) return nullptr;
+            std::memcpy(first, text, length);
+            return first + length;
+        }
+
+        inline const char* SkipSpaces(const char* first, const char* last)
+        {
+            while (first != last && *first == ' ') ++first;
+            return first;
+        }
+
+        inline bool IsNameCharacter(char character)
+        {
+            return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') || (character >= '0' && character <= '9');
+        }
+
+        // Index of the component called name, -1 when Element has none
+        template <typename Element>
+        int FindComponent(const char* first, const char* last)
+        {
+            const auto names{ Element::names() };
+            const size_t length{ static_cast<size_t>(last - first) };
+            for (size_t idx{}; idx < names.size(); ++idx)
+            {
+                if (std::strlen(names[idx]) == length && std::memcmp(names[idx], first, length) == 0) return static_cast<int>(idx);
+            }
+            return -1;
+        }
+    }
+
+    // Writes element into [first, last) and returns the end of the text, nullptr when it does not fit.
+    // Like std::to_chars no terminating zero is written.
+    template <typename Element>
+    char* Format(char* first, char* last, const Element& element)
+    {
+        const auto names{ Element::names() };
+        bool empty{ true };
+        for (size_t idx{}; idx < names.size(); ++idx)
+        {
+            const float value{ element[idx] };
+            const float magnitude{ value < 0 ? -value : value };
+            if (!(magnitude > g_ZeroThreshold)) continue;
+
+            first = detail::Append(first, last, empty ? (value < 0 ? "-" : "") : (value < 0 ? " - " : " + "));
+            if (first == nullptr) return nullptr;
+
+            const bool named{ names[idx][0] != '\0' };
+            if (magnitude != 1)
+            {
+                const std::to_chars_result result{ std::to_chars(first, last, magnitude) };
+                if (result.ec != std::errc{}) return nullptr;
+                first = result.ptr;
+                if (named) first = detail::Append(first, last, "*");
+            }
+            if (named) first = detail::Append(first, last, names[idx]);
+            else if (magnitude == 1) first = detail::Append(first, last, "1");
+            if (first == nullptr) return nullptr;
+            empty = false;
+        }
+        return empty ? detail::Append(first, last, "0") : first;
+    }
+
+    // Reads an element in the Format / toString format from [first, last) into element and returns
+    // the end of what was read, nullptr on malformed text or a basis name Element does not have.
+    // Parsing stops at the first character that cannot continue the sum, the caller decides whether that is an error.
+    template <typename Element>
+    const char* Parse(const char* first, const char* last, Element& element)
+    {
+        element = Element{};
+        first = detail::SkipSpaces(first, last);
+        bool negative{ false };
+        if (first != last && *first == '-')
+        {
+            negative = true;
+            first = detail::SkipSpaces(first + 1, last);
+        }
+
+        while (true)
+        {
+            if (first == last) return nullptr;
+
+            //a term is number*name, name or a bare number for the scalar part
+            float value{ 1 };
+            bool hasNumber{ false };
+            if (!detail::IsNameCharacter(*first) || (*first >= '0' && *first <= '9') || *first == 'i' || *first == 'n')
+            {
+                const std::from_chars_result result{ std::from_chars(first, last, value) };
+                if (result.ec != std::errc{}) return nullptr;
+                first = result.ptr;
+                hasNumber = true;
+            }
+
+            const char* afterNumber{ detail::SkipSpaces(first, last) };
+            int component{ -1 };
+            if (!hasNumber || (afterNumber != last && *afterNumber == '*'))
+            {
+                const char* nameFirst{ hasNumber ? detail::SkipSpaces(afterNumber + 1, last) : first };
+                const char* nameLast{ nameFirst };
+                while (nameLast != last && detail::IsNameCharacter(*nameLast)) ++nameLast;
+                component = detail::FindComponent<Element>(nameFirst, nameLast);
+                if (component < 0) return nullptr;
+                first = nameLast;
+            }
+            else
+            {
+                component = detail::FindComponent<Element>(first, first);
+                //"0" is how an all zero element is written, also for types without a scalar part
+                if (component < 0 && value != 0) return nullptr;
+            }
+
+            if (component >= 0) element[component] += negative ? -value : value;
+
+            const char* next{ detail::SkipSpaces(first, last) };
+            if (next == last || (*next != '+' && *next != '-')) return first;
+            negative = *next == '-';
+            first = detail::SkipSpaces(next + 1, last);
+        }
+    }
+}
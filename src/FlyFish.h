@@ -194,19 +194,9 @@ public:
         return d;
     }
 
-    //template<typename Other>
-    //[[nodiscard]] Derived Reject(Other& b) const
-    //{
-    //    return (*this ^ b) * ~b;
-    //}
-
-    //template<typename Other>
-    //[[nodiscard]] Derived Project(Other& b) const
-    //{
-    //    return (*this | b) * ~b;
-    //}
+    // Projection and rejection, (a | b) * ~b written out per blade pair: see Projection.h
 
-    friend [[nodiscard]] Derived operator*(float scalar, const Derived& element) {
+    [[nodiscard]] friend Derived operator*(float scalar, const Derived& element) {
         return element * scalar;
     }
 
@@ -801,22 +791,22 @@ public:
     }
 
     template <typename Derived>
-    friend [[nodiscard]] GANull operator* (const Derived& b, const GANull& element)
+    [[nodiscard]] friend GANull operator* (const Derived& b, const GANull& element)
     {
         return GANull{};
     }
     template <typename Derived>
-    friend [[nodiscard]] GANull operator| (const Derived& b, const GANull& element)
+    [[nodiscard]] friend GANull operator| (const Derived& b, const GANull& element)
     {
         return GANull{};
     }
     template <typename Derived>
-    friend [[nodiscard]] GANull operator^ (const Derived& b, const GANull& element)
+    [[nodiscard]] friend GANull operator^ (const Derived& b, const GANull& element)
     {
         return GANull{};
     }
     template <typename Derived>
-    friend [[nodiscard]] GANull operator& (const Derived& b, const GANull& element)
+    [[nodiscard]] friend GANull operator& (const Derived& b, const GANull& element)
     {
         return GANull{};
     }
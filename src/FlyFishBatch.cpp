@@ -0,0 +1,461 @@
+#include "FlyFishBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // Parallel lines have no common perpendicular, their distance comes from the moments instead
+    constexpr float g_ParallelTolerance{ 1e-6f };
+
+    struct UnitPlane
+    {
+        explicit UnitPlane(const OneBlade& plane)
+        {
+            const float normal{ 1 / plane.Norm() };
+            e0 = plane[0] * normal;
+            e1 = plane[1] * normal;
+            e2 = plane[2] * normal;
+            e3 = plane[3] * normal;
+        }
+        float e0, e1, e2, e3;
+    };
+
+    struct UnitLine
+    {
+        explicit UnitLine(const TwoBlade& line)
+        {
+            const float direction{ 1 / line.Norm() };
+            mx = line[0] * direction;
+            my = line[1] * direction;
+            mz = line[2] * direction;
+            dx = line[3] * direction;
+            dy = line[4] * direction;
+            dz = line[5] * direction;
+        }
+        float mx, my, mz, dx, dy, dz;
+    };
+
+    // plane & point, divided by the point weight
+    inline float PointPlaneDistance(float x, float y, float z, float w, const UnitPlane& plane)
+    {
+        return (plane.e0 * w + plane.e1 * x + plane.e2 * y + plane.e3 * z) / w;
+    }
+
+    // |w m - p x d| is the weight of the plane through the line and the point (line & point)
+    inline float PointLineDistance(float x, float y, float z, float w, const UnitLine& line)
+    {
+        const float px{ w * line.mx - (y * line.dz - z * line.dy) };
+        const float py{ w * line.my - (z * line.dx - x * line.dz) };
+        const float pz{ w * line.mz - (x * line.dy - y * line.dx) };
+        return std::sqrt(px * px + py * py + pz * pz) / std::fabs(w);
+    }
+
+    inline float LineLineDistance(float m0, float m1, float m2, float d0, float d1, float d2, const UnitLine& line)
+    {
+        const float invLength{ 1 / std::sqrt(d0 * d0 + d1 * d1 + d2 * d2) };
+
+        //line & line is the moment of the lines around each other
+        const float moment{ (d0 * line.mx + d1 * line.my + d2 * line.mz + m0 * line.dx + m1 * line.dy + m2 * line.dz) * invLength };
+
+        const float cx{ d1 * line.dz - d2 * line.dy };
+        const float cy{ d2 * line.dx - d0 * line.dz };
+        const float cz{ d0 * line.dy - d1 * line.dx };
+        const float sine{ std::sqrt(cx * cx + cy * cy + cz * cz) * invLength };
+
+        //parallel: the difference of the normalized moments is the offset between the lines
+        const float orientation{ (d0 * line.dx + d1 * line.dy + d2 * line.dz) < 0 ? -invLength : invLength };
+        const float ox{ m0 * orientation - line.mx };
+        const float oy{ m1 * orientation - line.my };
+        const float oz{ m2 * orientation - line.mz };
+        const float offset{ std::sqrt(ox * ox + oy * oy + oz * oz) };
+
+        return sine > g_ParallelTolerance ? std::fabs(moment) / sine : offset;
+    }
+
+    void PointPlaneRow(const PointBatch& points, const UnitPlane& plane, float* out)
+    {
+        const float* x{ points.Component(0) };
+        const float* y{ points.Component(1) };
+        const float* z{ points.Component(2) };
+        const float* w{ points.Component(3) };
+
+        const size_t count{ points.Size() };
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            out[idx] = PointPlaneDistance(x[idx], y[idx], z[idx], w[idx], plane);
+        }
+    }
+
+    void PointLineRow(const PointBatch& points, const UnitLine& line, float* out)
+    {
+        const float* x{ points.Component(0) };
+        const float* y{ points.Component(1) };
+        const float* z{ points.Component(2) };
+        const float* w{ points.Component(3) };
+
+        const size_t count{ points.Size() };
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            out[idx] = PointLineDistance(x[idx], y[idx], z[idx], w[idx], line);
+        }
+    }
+
+    void LineLineRow(const LineBatch& lines, const UnitLine& line, float* out)
+    {
+        const float* m0{ lines.Component(0) };
+        const float* m1{ lines.Component(1) };
+        const float* m2{ lines.Component(2) };
+        const float* d0{ lines.Component(3) };
+        const float* d1{ lines.Component(4) };
+        const float* d2{ lines.Component(5) };
+
+        const size_t count{ lines.Size() };
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            out[idx] = LineLineDistance(m0[idx], m1[idx], m2[idx], d0[idx], d1[idx], d2[idx], line);
+        }
+    }
+
+    // Tests the first batch against one element of the second batch at a time.
+    // While most elements are unresolved the vectorized row kernel runs over the whole batch,
+    // once few remain only those are tested with the pair kernel.
+    template <typename RowKernel, typename PairKernel>
+    size_t CollectHits(size_t firstCount, size_t secondCount, float threshold, int* firstHit, RowKernel rowKernel, PairKernel pairKernel)
+    {
+        std::vector<float> row(firstCount);
+        std::vector<size_t> active{};
+        size_t remaining{ firstCount };
+
+        for (size_t idx{}; idx < firstCount; ++idx) firstHit[idx] = -1;
+
+        for (size_t second{}; second < secondCount && remaining > 0; ++second)
+        {
+            if (remaining * 4 > firstCount)
+            {
+                rowKernel(second, row.data());
+                for (size_t first{}; first < firstCount; ++first)
+                {
+                    const bool hit{ firstHit[first] < 0 && std::fabs(row[first]) < threshold };
+                    firstHit[first] = hit ? static_cast<int>(second) : firstHit[first];
+                    remaining -= hit;
+                }
+                continue;
+            }
+
+            if (active.empty())
+            {
+                for (size_t first{}; first < firstCount; ++first)
+                {
+                    if (firstHit[first] < 0) active.push_back(first);
+                }
+            }
+            for (size_t first : active)
+            {
+                if (std::fabs(pairKernel(first, second)) < threshold) firstHit[first] = static_cast<int>(second);
+            }
+            std::erase_if(active, [firstHit](size_t first) { return firstHit[first] >= 0; });
+            remaining = active.size();
+        }
+
+        return firstCount - remaining;
+    }
+}
+
+void batch::PointPlaneDistances(const PointBatch& points, const PlaneBatch& planes, float* out)
+{
+    for (size_t plane{}; plane < planes.Size(); ++plane)
+    {
+        PointPlaneRow(points, UnitPlane{ planes.Get(plane) }, out + plane * points.Size());
+    }
+}
+
+void batch::PointLineDistances(const PointBatch& points, const LineBatch& lines, float* out)
+{
+    for (size_t line{}; line < lines.Size(); ++line)
+    {
+        PointLineRow(points, UnitLine{ lines.Get(line) }, out + line * points.Size());
+    }
+}
+
+void batch::LineLineDistances(const LineBatch& linesA, const LineBatch& linesB, float* out)
+{
+    for (size_t line{}; line < linesB.Size(); ++line)
+    {
+        LineLineRow(linesA, UnitLine{ linesB.Get(line) }, out + line * linesA.Size());
+    }
+}
+
+size_t batch::PointPlaneHits(const PointBatch& points, const PlaneBatch& planes, float threshold, int* firstHit)
+{
+    std::vector<UnitPlane> unitPlanes{};
+    for (size_t plane{}; plane < planes.Size(); ++plane) unitPlanes.emplace_back(planes.Get(plane));
+
+    return CollectHits(points.Size(), planes.Size(), threshold, firstHit,
+        [&](size_t plane, float* row) { PointPlaneRow(points, unitPlanes[plane], row); },
+        [&](size_t point, size_t plane)
+        {
+            return PointPlaneDistance(points.Component(0)[point], points.Component(1)[point],
+                points.Component(2)[point], points.Component(3)[point], unitPlanes[plane]);
+        });
+}
+
+size_t batch::PointLineHits(const PointBatch& points, const LineBatch& lines, float threshold, int* firstHit)
+{
+    std::vector<UnitLine> unitLines{};
+    for (size_t line{}; line < lines.Size(); ++line) unitLines.emplace_back(lines.Get(line));
+
+    return CollectHits(points.Size(), lines.Size(), threshold, firstHit,
+        [&](size_t line, float* row) { PointLineRow(points, unitLines[line], row); },
+        [&](size_t point, size_t line)
+        {
+            return PointLineDistance(points.Component(0)[point], points.Component(1)[point],
+                points.Component(2)[point], points.Component(3)[point], unitLines[line]);
+        });
+}
+
+size_t batch::LineLineHits(const LineBatch& linesA, const LineBatch& linesB, float threshold, int* firstHit)
+{
+    std::vector<UnitLine> unitLines{};
+    for (size_t line{}; line < linesB.Size(); ++line) unitLines.emplace_back(linesB.Get(line));
+
+    return CollectHits(linesA.Size(), linesB.Size(), threshold, firstHit,
+        [&](size_t line, float* row) { LineLineRow(linesA, unitLines[line], row); },
+        [&](size_t first, size_t line)
+        {
+            return LineLineDistance(linesA.Component(0)[first], linesA.Component(1)[first], linesA.Component(2)[first],
+                linesA.Component(3)[first], linesA.Component(4)[first], linesA.Component(5)[first], unitLines[line]);
+        });
+}
+
+void batch::PointPlaneSeparations(const PointBatch& points, const PlaneBatch& planes, float* out)
+{
+    const float* e0{ planes.Component(0) };
+    const float* e1{ planes.Component(1) };
+    const float* e2{ planes.Component(2) };
+    const float* e3{ planes.Component(3) };
+
+    //shapes have few vertices and faces, the planes are the inner loop so the running minimum needs no reduction.
+    //Planes go in chunks so their inverse norms fit on the stack and are taken once instead of once per point
+    constexpr size_t chunkSize{ 64 };
+    float inverseNorms[chunkSize];
+
+    for (size_t first{}; first < planes.Size(); first += chunkSize)
+    {
+        const size_t chunk{ std::min(chunkSize, planes.Size() - first) };
+        float* minimum{ out + first };
+        FLYFISH_VECTORIZE
+        for (size_t plane{}; plane < chunk; ++plane)
+        {
+            const size_t at{ first + plane };
+            inverseNorms[plane] = 1 / std::sqrt(e1[at] * e1[at] + e2[at] * e2[at] + e3[at] * e3[at]);
+            minimum[plane] = std::numeric_limits<float>::infinity();
+        }
+
+        for (size_t point{}; point < points.Size(); ++point)
+        {
+            const ThreeBlade p{ points.Get(point) };
+            const float inverseWeight{ 1 / p[3] };
+            const float x{ p[0] * inverseWeight }, y{ p[1] * inverseWeight }, z{ p[2] * inverseWeight };
+            FLYFISH_VECTORIZE
+            for (size_t plane{}; plane < chunk; ++plane)
+            {
+                const size_t at{ first + plane };
+                const float distance{ (e0[at] + e1[at] * x + e2[at] * y + e3[at] * z) * inverseNorms[plane] };
+                minimum[plane] = std::min(minimum[plane], distance);
+            }
+        }
+    }
+}
+
+size_t batch::CullSpheres(const PointBatch& centers, const float* radii, const PlaneBatch& planes, int* visible)
+{
+    const float* x{ centers.Component(0) };
+    const float* y{ centers.Component(1) };
+    const float* z{ centers.Component(2) };
+    const float* w{ centers.Component(3) };
+
+    const size_t count{ centers.Size() };
+    for (size_t idx{}; idx < count; ++idx) visible[idx] = 1;
+
+    for (size_t plane{}; plane < planes.Size(); ++plane)
+    {
+        const UnitPlane unit{ planes.Get(plane) };
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            visible[idx] &= PointPlaneDistance(x[idx], y[idx], z[idx], w[idx], unit) >= -radii[idx];
+        }
+    }
+
+    size_t visibleCount{};
+    for (size_t idx{}; idx < count; ++idx) visibleCount += visible[idx];
+    return visibleCount;
+}
+
+void batch::JoinPoints(const PointBatch& pointsA, const PointBatch& pointsB, LineBatch& out)
+{
+    const size_t count{ std::min(pointsA.Size(), pointsB.Size()) };
+    out.Resize(count);
+
+    const float* ax{ pointsA.Component(0) };
+    const float* ay{ pointsA.Component(1) };
+    const float* az{ pointsA.Component(2) };
+    const float* aw{ pointsA.Component(3) };
+    const float* bx{ pointsB.Component(0) };
+    const float* by{ pointsB.Component(1) };
+    const float* bz{ pointsB.Component(2) };
+    const float* bw{ pointsB.Component(3) };
+    float* e01{ out.Component(0) };
+    float* e02{ out.Component(1) };
+    float* e03{ out.Component(2) };
+    float* e23{ out.Component(3) };
+    float* e31{ out.Component(4) };
+    float* e12{ out.Component(5) };
+
+    FLYFISH_VECTORIZE
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        e01[idx] = bz[idx] * ay[idx] - by[idx] * az[idx];
+        e02[idx] = -bz[idx] * ax[idx] + bx[idx] * az[idx];
+        e03[idx] = by[idx] * ax[idx] - bx[idx] * ay[idx];
+        e23[idx] = bx[idx] * aw[idx] - bw[idx] * ax[idx];
+        e31[idx] = by[idx] * aw[idx] - bw[idx] * ay[idx];
+        e12[idx] = bz[idx] * aw[idx] - bw[idx] * az[idx];
+    }
+}
+
+void batch::JoinPointLine(const PointBatch& points, const LineBatch& lines, PlaneBatch& out)
+{
+    const size_t count{ std::min(points.Size(), lines.Size()) };
+    out.Resize(count);
+
+    const float* x{ points.Component(0) };
+    const float* y{ points.Component(1) };
+    const float* z{ points.Component(2) };
+    const float* w{ points.Component(3) };
+    const float* e01{ lines.Component(0) };
+    const float* e02{ lines.Component(1) };
+    const float* e03{ lines.Component(2) };
+    const float* e23{ lines.Component(3) };
+    const float* e31{ lines.Component(4) };
+    const float* e12{ lines.Component(5) };
+    float* e0{ out.Component(0) };
+    float* e1{ out.Component(1) };
+    float* e2{ out.Component(2) };
+    float* e3{ out.Component(3) };
+
+    FLYFISH_VECTORIZE
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        e0[idx] = -z[idx] * e03[idx] - y[idx] * e02[idx] - x[idx] * e01[idx];
+        e1[idx] = z[idx] * e31[idx] - y[idx] * e12[idx] + w[idx] * e01[idx];
+        e2[idx] = -z[idx] * e23[idx] + x[idx] * e12[idx] + w[idx] * e02[idx];
+        e3[idx] = y[idx] * e23[idx] - x[idx] * e31[idx] + w[idx] * e03[idx];
+    }
+}
+
+void batch::MeetPlanes(const PlaneBatch& planesA, const PlaneBatch& planesB, LineBatch& out)
+{
+    const size_t count{ std::min(planesA.Size(), planesB.Size()) };
+    out.Resize(count);
+
+    const float* a0{ planesA.Component(0) };
+    const float* a1{ planesA.Component(1) };
+    const float* a2{ planesA.Component(2) };
+    const float* a3{ planesA.Component(3) };
+    const float* b0{ planesB.Component(0) };
+    const float* b1{ planesB.Component(1) };
+    const float* b2{ planesB.Component(2) };
+    const float* b3{ planesB.Component(3) };
+    float* e01{ out.Component(0) };
+    float* e02{ out.Component(1) };
+    float* e03{ out.Component(2) };
+    float* e23{ out.Component(3) };
+    float* e31{ out.Component(4) };
+    float* e12{ out.Component(5) };
+
+    FLYFISH_VECTORIZE
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        e01[idx] = a1[idx] * b0[idx] - a0[idx] * b1[idx];
+        e02[idx] = a2[idx] * b0[idx] - a0[idx] * b2[idx];
+        e03[idx] = a3[idx] * b0[idx] - a0[idx] * b3[idx];
+        e23[idx] = a3[idx] * b2[idx] - a2[idx] * b3[idx];
+        e31[idx] = -a3[idx] * b1[idx] + a1[idx] * b3[idx];
+        e12[idx] = a2[idx] * b1[idx] - a1[idx] * b2[idx];
+    }
+}
+
+void batch::MeetPlanes(const PlaneBatch& planesA, const PlaneBatch& planesB, const PlaneBatch& planesC, PointBatch& out)
+{
+    const size_t count{ std::min({ planesA.Size(), planesB.Size(), planesC.Size() }) };
+    out.Resize(count);
+
+    const float* a0{ planesA.Component(0) };
+    const float* a1{ planesA.Component(1) };
+    const float* a2{ planesA.Component(2) };
+    const float* a3{ planesA.Component(3) };
+    const float* b0{ planesB.Component(0) };
+    const float* b1{ planesB.Component(1) };
+    const float* b2{ planesB.Component(2) };
+    const float* b3{ planesB.Component(3) };
+    const float* c0{ planesC.Component(0) };
+    const float* c1{ planesC.Component(1) };
+    const float* c2{ planesC.Component(2) };
+    const float* c3{ planesC.Component(3) };
+    float* x{ out.Component(0) };
+    float* y{ out.Component(1) };
+    float* z{ out.Component(2) };
+    float* w{ out.Component(3) };
+
+    FLYFISH_VECTORIZE
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        const float e01{ a1[idx] * b0[idx] - a0[idx] * b1[idx] };
+        const float e02{ a2[idx] * b0[idx] - a0[idx] * b2[idx] };
+        const float e03{ a3[idx] * b0[idx] - a0[idx] * b3[idx] };
+        const float e23{ a3[idx] * b2[idx] - a2[idx] * b3[idx] };
+        const float e31{ -a3[idx] * b1[idx] + a1[idx] * b3[idx] };
+        const float e12{ a2[idx] * b1[idx] - a1[idx] * b2[idx] };
+
+        x[idx] = -e23 * c0[idx] + e03 * c2[idx] - e02 * c3[idx];
+        y[idx] = -e31 * c0[idx] - e03 * c1[idx] + e01 * c3[idx];
+        z[idx] = -e12 * c0[idx] + e02 * c1[idx] - e01 * c2[idx];
+        w[idx] = e23 * c1[idx] + e31 * c2[idx] + e12 * c3[idx];
+    }
+}
+
+void batch::MeetLinePlane(const LineBatch& lines, const PlaneBatch& planes, PointBatch& out)
+{
+    const size_t count{ std::min(lines.Size(), planes.Size()) };
+    out.Resize(count);
+
+    const float* e01{ lines.Component(0) };
+    const float* e02{ lines.Component(1) };
+    const float* e03{ lines.Component(2) };
+    const float* e23{ lines.Component(3) };
+    const float* e31{ lines.Component(4) };
+    const float* e12{ lines.Component(5) };
+    const float* e0{ planes.Component(0) };
+    const float* e1{ planes.Component(1) };
+    const float* e2{ planes.Component(2) };
+    const float* e3{ planes.Component(3) };
+    float* x{ out.Component(0) };
+    float* y{ out.Component(1) };
+    float* z{ out.Component(2) };
+    float* w{ out.Component(3) };
+
+    FLYFISH_VECTORIZE
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        x[idx] = -e23[idx] * e0[idx] + e03[idx] * e2[idx] - e02[idx] * e3[idx];
+        y[idx] = -e31[idx] * e0[idx] - e03[idx] * e1[idx] + e01[idx] * e3[idx];
+        z[idx] = -e12[idx] * e0[idx] + e02[idx] * e1[idx] - e01[idx] * e2[idx];
+        w[idx] = e23[idx] * e1[idx] + e31[idx] * e2[idx] + e12[idx] * e3[idx];
+    }
+}
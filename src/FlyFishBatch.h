@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "FlyFish.h"
+
+// Batch outputs never alias their inputs, so kernel loops skip the compiler's runtime overlap checks
+#if defined(_MSC_VER) && !defined(__clang__)
+#define FLYFISH_VECTORIZE __pragma(loop(ivdep))
+#elif defined(__clang__)
+#define FLYFISH_VECTORIZE _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define FLYFISH_VECTORIZE _Pragma("GCC ivdep")
+#else
+#define FLYFISH_VECTORIZE
+#endif
+
+// Structure-of-arrays storage for FlyFish elements.
+// Every component (e.g. all e032 coordinates of a PointBatch) is one contiguous float array,
+// so batch kernels stream through memory and the inner loops vectorize.
+template <typename Element, size_t ComponentCount>
+class ElementBatch
+{
+public:
+    static constexpr size_t Components{ ComponentCount };
+
+    ElementBatch() = default;
+
+    explicit ElementBatch(size_t size)
+    {
+        Resize(size);
+    }
+
+    ElementBatch(const std::vector<Element>& elements)
+    {
+        Reserve(elements.size());
+        for (const Element& element : elements)
+        {
+            PushBack(element);
+        }
+    }
+
+    ElementBatch(const ElementBatch& other)
+    {
+        *this = other;
+    }
+
+    ElementBatch(ElementBatch&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    ElementBatch& operator=(const ElementBatch& other)
+    {
+        if (this == &other) return *this;
+        m_Storage = other.m_Storage;
+        m_Data = other.IsView() ? other.m_Data : m_Storage.data();
+        m_Size = other.m_Size;
+        m_Stride = other.m_Stride;
+        return *this;
+    }
+
+    ElementBatch& operator=(ElementBatch&& other) noexcept
+    {
+        if (this == &other) return *this;
+        //moving a vector keeps its buffer, so m_Data stays valid for owned storage too
+        m_Storage = std::move(other.m_Storage);
+        m_Data = other.m_Data;
+        m_Size = other.m_Size;
+        m_Stride = other.m_Stride;
+        other.m_Storage.clear();
+        other.m_Data = nullptr;
+        other.m_Size = 0;
+        other.m_Stride = 0;
+        return *this;
+    }
+
+    // Batch over memory someone else owns, e.g. a mapped file. Component c starts at data + c * stride.
+    // Nothing is copied until the batch grows past stride, the memory has to outlive the view.
+    [[nodiscard]] static ElementBatch View(float* data, size_t size, size_t stride)
+    {
+        ElementBatch batch{};
+        batch.m_Data = data;
+        batch.m_Size = size;
+        batch.m_Stride = stride;
+        return batch;
+    }
+
+    [[nodiscard]] size_t Size() const { return m_Size; }
+    [[nodiscard]] bool Empty() const { return m_Size == 0; }
+    // Floats between the starts of two component arrays
+    [[nodiscard]] size_t Stride() const { return m_Stride; }
+    [[nodiscard]] bool IsView() const { return m_Data != m_Storage.data(); }
+
+    [[nodiscard]] float* Component(size_t component) { return m_Data + component * m_Stride; }
+    [[nodiscard]] const float* Component(size_t component) const { return m_Data + component * m_Stride; }
+
+    void Reserve(size_t capacity)
+    {
+        if (capacity <= m_Stride) return;
+
+        //keep every component array 64 byte granular so they all start equally aligned
+        const size_t newStride{ (capacity + 15) / 16 * 16 };
+        std::vector<float> storage(newStride * Components);
+        for (size_t component{}; component < Components; ++component)
+        {
+            for (size_t idx{}; idx < m_Size; ++idx)
+            {
+                storage[component * newStride + idx] = m_Data[component * m_Stride + idx];
+            }
+        }
+        m_Storage = std::move(storage);
+        m_Data = m_Storage.data();
+        m_Stride = newStride;
+    }
+
+    void Resize(size_t size)
+    {
+        Reserve(size);
+        for (size_t component{}; component < Components; ++component)
+        {
+            for (size_t idx{ m_Size }; idx < size; ++idx)
+            {
+                Component(component)[idx] = 0;
+            }
+        }
+        m_Size = size;
+    }
+
+    void Clear() { m_Size = 0; }
+
+    void PushBack(const Element& element)
+    {
+        if (m_Size == m_Stride) Reserve(m_Stride == 0 ? 16 : m_Stride * 2);
+        Set(m_Size++, element);
+    }
+
+    [[nodiscard]] Element Get(size_t idx) const
+    {
+        Element element{};
+        for (size_t component{}; component < Components; ++component)
+        {
+            element[component] = Component(component)[idx];
+        }
+        return element;
+    }
+
+    void Set(size_t idx, const Element& element)
+    {
+        for (size_t component{}; component < Components; ++component)
+        {
+            Component(component)[idx] = element[component];
+        }
+    }
+
+private:
+    std::vector<float> m_Storage{};
+    //m_Storage.data() unless the batch is a view
+    float* m_Data{};
+    size_t m_Size{};
+    size_t m_Stride{};
+};
+
+using PlaneBatch = ElementBatch<OneBlade, 4>;
+using LineBatch = ElementBatch<TwoBlade, 6>;
+using PointBatch = ElementBatch<ThreeBlade, 4>;
+using MotorBatch = ElementBatch<Motor, 8>;
+
+namespace batch
+{
+    // Distance kernels. Results are stored row major per element of the second batch:
+    // out[second * first.Size() + first], so out needs first.Size() * second.Size() floats.
+
+    // Signed distance, positive on the side the plane normal points to (same as plane & point)
+    void PointPlaneDistances(const PointBatch& points, const PlaneBatch& planes, float* out);
+    void PointLineDistances(const PointBatch& points, const LineBatch& lines, float* out);
+    void LineLineDistances(const LineBatch& linesA, const LineBatch& linesB, float* out);
+
+    // Hit queries with an early out: firstHit[i] receives the index of the first element of the
+    // second batch closer than threshold to element i, or -1 when there is none.
+    // Elements that already hit are not tested further and the scan stops once every element hit.
+    // Returns the number of elements that hit something.
+    size_t PointPlaneHits(const PointBatch& points, const PlaneBatch& planes, float threshold, int* firstHit);
+    size_t PointLineHits(const PointBatch& points, const LineBatch& lines, float threshold, int* firstHit);
+    size_t LineLineHits(const LineBatch& linesA, const LineBatch& linesB, float threshold, int* firstHit);
+
+    // out[plane] receives the smallest signed distance of any point to that plane, so out needs planes.Size() floats.
+    // A positive value means every point lies in front of the plane, the separating axis test of convex shapes.
+    void PointPlaneSeparations(const PointBatch& points, const PlaneBatch& planes, float* out);
+
+    // View volume culling. planes bound a convex volume with their normals pointing inside.
+    // visible[i] is set to 1 when the sphere around centers[i] with radii[i] reaches inside every plane, 0 otherwise.
+    // Returns the number of visible spheres.
+    size_t CullSpheres(const PointBatch& centers, const float* radii, const PlaneBatch& planes, int* visible);
+
+    // Join and meet kernels. Inputs are paired element by element, the shortest input decides
+    // the count and out is resized to it. Results match the FlyFish operators noted per kernel.
+
+    // pointsA[i] & pointsB[i]
+    void JoinPoints(const PointBatch& pointsA, const PointBatch& pointsB, LineBatch& out);
+    // points[i] & lines[i], the plane through both
+    void JoinPointLine(const PointBatch& points, const LineBatch& lines, PlaneBatch& out);
+    // planesA[i] ^ planesB[i]
+    void MeetPlanes(const PlaneBatch& planesA, const PlaneBatch& planesB, LineBatch& out);
+    // planesA[i] ^ planesB[i] ^ planesC[i], fused so the intermediate lines are never stored
+    void MeetPlanes(const PlaneBatch& planesA, const PlaneBatch& planesB, const PlaneBatch& planesC, PointBatch& out);
+    // lines[i] ^ planes[i]
+    void MeetLinePlane(const LineBatch& lines, const PlaneBatch& planes, PointBatch& out);
+}
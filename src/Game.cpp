@@ -11,6 +11,7 @@
 
 #include "utils.h"
 #include "structs.h"
+#include "Raycast.h"
 
 Game::Game(const Window& window)
 	: m_Window{ window }
@@ -260,18 +261,19 @@ void Game::CheckGameCollision()
 	//barriers are only passable when you have more than 50 energy
 	if (m_PlayerPosition[2] <= 50.f)
 	{
-		//get the player center point for easy collision loop
-		auto centerOfPlayer = m_PlayerPosition;
-		centerOfPlayer[0] += m_PlayerSize / 2;
-		centerOfPlayer[1] += m_PlayerSize / 2;
-
-		int boundaryOverlap = CheckOverlapBarriers(centerOfPlayer, m_PlayerSize);
-		if (boundaryOverlap >= 0)
+		const ConvexShape playerShape{ ConvexShape::Rectangle(m_PlayerPosition[0], m_PlayerPosition[1], m_PlayerSize, m_PlayerSize) };
+		for (const auto& b : m_BarrierVec)
 		{
-			OneBlade ref = { m_BarrierVec[boundaryOverlap]->GetPos()[0],1,0,0 };
+			//reflect on the barrier face the player pushes into
+			const Contact contact{ collision::Overlap(playerShape, b->GetShape()) };
+			if (contact.overlap)
+			{
+				OneBlade ref = contact.normal;
 
-			if (m_IsRotating) m_PlayerDirectionRotation = -m_PlayerDirectionRotation;
-			else m_PlayerDirection = (ref * m_PlayerDirection * ~ref).Grade2();
+				if (m_IsRotating) m_PlayerDirectionRotation = -m_PlayerDirectionRotation;
+				else m_PlayerDirection = (ref * m_PlayerDirection * ~ref).Grade2();
+				break;
+			}
 		}
 	}
 }
@@ -307,24 +309,35 @@ void Game::ManageRotation(float deltaTime)
 {
 	//rotate around the selected Pillar
 
-	//translation to the selected pillar
-	Motor translator{ Motor::Translation(m_PillarsVec[m_SelectedPillar]->GetPos().VNorm(),
-		TwoBlade(m_PillarsVec[m_SelectedPillar]->GetPos()[0], m_PillarsVec[m_SelectedPillar]->GetPos()[1], 0, 0, 0, 0)) };
-
-	//rotation
-	const float rotSpeed = m_PlayerSpeed / 3 * deltaTime;
-	Motor rotation{ Motor::Rotation(rotSpeed,m_PlayerDirectionRotation) };
-
-	//full rotation & translation around the pillar
-	Motor rotTranslations{ translator * rotation * ~translator };
-	m_PlayerPosition = (rotTranslations * m_PlayerPosition * ~rotTranslations).Grade3();
+	//a new orbit starts when rotating starts or the pillar changed or moved, until then it is evaluated from time alone
+	const ThreeBlade& pillar{ m_PillarsVec[m_SelectedPillar]->GetPos() };
+	const float rotSpeed = m_PlayerSpeed / 3 * m_PlayerDirectionRotation[5];
+	if (!m_IsOrbiting || !(pillar == m_OrbitPillar))
+	{
+		//the vertical line through the pillar
+		Motor translator{ Motor::Translation(pillar.VNorm(), TwoBlade(pillar[0], pillar[1], 0, 0, 0, 0)) };
+		const TwoBlade axis{ (translator * TwoBlade{ 0, 0, 0, 0, 0, 1 } * ~translator).Grade2() };
+		m_PlayerOrbit = Orbit{ axis, m_PlayerPosition, rotSpeed, m_OrbitTime };
+		m_OrbitPillar = pillar;
+		m_IsOrbiting = true;
+	}
+	else if (rotSpeed * DEG_TO_RAD != m_PlayerOrbit.AngularSpeed()) m_PlayerOrbit.SetSpeed(m_OrbitTime, rotSpeed);
 
+	//only x and y, the third coordinate holds the energy
+	m_OrbitTime += deltaTime;
+	const ThreeBlade position{ m_PlayerOrbit.At(m_OrbitTime) };
+	m_PlayerPosition[0] = position[0];
+	m_PlayerPosition[1] = position[1];
 }
 
 void Game::MovePlayer(float deltaTime)
 {
 	if (m_IsRotating) ManageRotation(deltaTime);
-	else TranslatePlayer(deltaTime);
+	else
+	{
+		m_IsOrbiting = false;
+		TranslatePlayer(deltaTime);
+	}
 }
 
 void Game::ReflectPlayer()
@@ -333,6 +346,7 @@ void Game::ReflectPlayer()
 	auto powerLevel = m_PlayerPosition[2];
 	m_PlayerPosition = (m_PillarsVec[m_SelectedPillar]->GetPos() * m_PlayerPosition * ~m_PillarsVec[m_SelectedPillar]->GetPos()).Grade3();
 	m_PlayerPosition[2] = powerLevel;
+	m_IsOrbiting = false;
 
 	//check if off screen, if so put it at the most far away point
 	if (m_PlayerPosition[0] - m_PlayerSize >= m_Window.width) m_PlayerPosition[0] = m_Window.width - m_PlayerSize;
@@ -367,15 +381,6 @@ void Game::ColorPillars()
 	}
 }
 
-void Game::DrawPillars() const
-{
-	//draw all the pillars on screen
-	for (const auto& p : m_PillarsVec)
-	{
-		p->Draw();
-	}
-}
-
 void Game::SpawnPillar()
 {
 	//Add a pillar when pressing a button to where the player is
@@ -424,19 +429,6 @@ void Game::MakeNewPickup()
 	}
 }
 
-void Game::DrawPickups() const
-{
-	//draw all the pickups on screen
-	//Pickups are only visible when you have more than 30% of energy
-	if (m_PlayerPosition[2] >= 30)
-	{
-		for (const auto& p : m_PickupsVec)
-		{
-			p->Draw();
-		}
-	}
-}
-
 void Game::PickupCollision()
 {
 	//get the player center point for easy collision loop
@@ -467,15 +459,46 @@ void Game::InitGameItems()
 		10,m_Window.height));
 }
 
-void Game::DrawGameItems() const
+void Game::CullGameItems()
 {
-	DrawPillars();
-	DrawPickups();
+	//collect everything that could be drawn this frame, in draw order
+	m_CullCandidates.clear();
+	for (const auto& p : m_PillarsVec) m_CullCandidates.push_back(p.get());
+	//Pickups are only visible when you have more than 30% of energy
+	if (m_PlayerPosition[2] >= 30)
+	{
+		for (const auto& p : m_PickupsVec) m_CullCandidates.push_back(p.get());
+	}
+	for (const auto& b : m_BarrierVec) m_CullCandidates.push_back(b.get());
 
-	//barrier
-	for (const auto& b : m_BarrierVec)
+	m_CullCenters.Clear();
+	m_CullRadii.clear();
+	for (const GameItem* item : m_CullCandidates)
+	{
+		const Sphere bounds{ item->GetBounds() };
+		m_CullCenters.PushBack(bounds.center);
+		m_CullRadii.push_back(bounds.radius);
+	}
+
+	//test all bounds against the view planes at once, only survivors reach Draw
+	m_CullVisible.resize(m_CullCandidates.size());
+	batch::CullSpheres(m_CullCenters, m_CullRadii.data(), m_ViewPlanes, m_CullVisible.data());
+
+	m_VisibleItems.clear();
+	for (size_t i = 0; i < m_CullCandidates.size(); ++i)
 	{
-		b->Draw();
+		if (m_CullVisible[i]) m_VisibleItems.push_back(m_CullCandidates[i]);
+	}
+
+	m_DrawnItems = static_cast<int>(m_VisibleItems.size());
+	m_CulledItems = static_cast<int>(m_CullCandidates.size()) - m_DrawnItems;
+}
+
+void Game::DrawGameItems() const
+{
+	for (const GameItem* item : m_VisibleItems)
+	{
+		item->Draw();
 	}
 }
 
@@ -566,8 +589,20 @@ void Game::MouseSelectPillar(const SDL_MouseButtonEvent& e)
 	//costs 1 point
 	if (m_PlayerScore >= 1)
 	{
-		ThreeBlade mousePos{ static_cast<float>(e.x),static_cast<float>(e.y),0 };
-		int selectedPillar = CheckOverlapPillars(mousePos, 0);
+		//cast a ray straight into the screen, the event loop already made y count from the bottom
+		const float mouseX{ static_cast<float>(e.x) };
+		const float mouseY{ static_cast<float>(e.y) };
+		const Ray mouseRay{ Ray::Through(ThreeBlade{ mouseX,mouseY,1 }, ThreeBlade{ mouseX,mouseY,0 }) };
+
+		RayScene pillars{};
+		for (const auto& p : m_PillarsVec)
+		{
+			const float size{ static_cast<float>(p->GetSize()) };
+			pillars.Add(Box{ ThreeBlade{ p->GetPos()[0],p->GetPos()[1],-1 },
+				ThreeBlade{ p->GetPos()[0] + size,p->GetPos()[1] + size,1 } });
+		}
+		const RayHit hit{ raycast::Cast(mouseRay, pillars) };
+		int selectedPillar = hit.index;
 		if (selectedPillar >=0 && !m_PillarsVec[selectedPillar]->IsSelected())
 		{
 			//select new pillar and deselect others
@@ -621,6 +656,8 @@ void Game::Update(float elapsedSec)
 
 	ManageEnergySpeed(elapsedSec);
 	VisualizeEnergy();
+
+	CullGameItems();
 }
 
 void Game::Draw() const
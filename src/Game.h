@@ -1,11 +1,13 @@
 #pragma once
 #include "FlyFish.h"
+#include "FlyFishBatch.h"
 #include "structs.h"
 #include "SDL.h"
 #include "SDL_opengl.h"
 #include <vector>
 
 #include "GameItem.h"
+#include "Orbit.h"
 
 class Game
 {
@@ -56,6 +58,16 @@ public:
 		return m_Viewport;
 	}
 
+	//items that passed and failed the view culling last frame
+	int GetDrawnItems() const
+	{
+		return m_DrawnItems;
+	}
+	int GetCulledItems() const
+	{
+		return m_CulledItems;
+	}
+
 private:
 	// DATA MEMBERS
 	// The window properties
@@ -81,6 +93,11 @@ private:
 	TwoBlade m_PlayerDirectionRotation{ 0,0,0,0,0,1 };
 	Motor m_PlayerMotor{ Motor::Translation(m_PlayerSpeed,m_PlayerDirection) };
 	bool m_IsRotating{ false };
+	//closed form orbit around m_OrbitPillar, evaluated at m_OrbitTime
+	Orbit m_PlayerOrbit{};
+	ThreeBlade m_OrbitPillar{ 0,0,0 };
+	float m_OrbitTime{};
+	bool m_IsOrbiting{ false };
 	int m_PlayerScore{ 0 };
 
 	// FUNCTIONS
@@ -123,7 +140,6 @@ private:
 	//pillar functions
 	void InitPillars();
 	void ColorPillars();
-	void DrawPillars() const;
 	void SpawnPillar();
 
 	//Pickups
@@ -139,7 +155,6 @@ private:
 	//pickup functions
 	void SpawnPickups();
 	void MakeNewPickup();
-	void DrawPickups() const;
 	void PickupCollision();
 
 	//Game items
@@ -148,6 +163,19 @@ private:
 
 	std::vector<std::unique_ptr<Barrier>> m_BarrierVec;
 
+	//Culling
+	//the window boundaries face inward, so they bound the view volume as they are
+	const PlaneBatch m_ViewPlanes{ m_WindowBoundaries };
+	std::vector<const GameItem*> m_CullCandidates{};
+	PointBatch m_CullCenters{};
+	std::vector<float> m_CullRadii{};
+	std::vector<int> m_CullVisible{};
+	std::vector<const GameItem*> m_VisibleItems{};
+	int m_DrawnItems{};
+	int m_CulledItems{};
+
+	void CullGameItems();
+
 	//Keyboard functions
 	void KeyboardSpeed(const SDL_KeyboardEvent& e);
 	void KeyboardPillar(const SDL_KeyboardEvent& e);
@@ -165,31 +193,23 @@ private:
 	{
 		int hasHit{ -1 };
 
+		//pos is the center of the square to collision check
+		const auto square = [&pos](float checkSize)
+			{
+				return ConvexShape::Rectangle(pos[0] - checkSize / 2, pos[1] - checkSize / 2, checkSize, checkSize);
+			};
+		//with a given size the square is the same for every item, build it once
+		const ConvexShape fixedShape{ size == 0 ? ConvexShape{} : square(static_cast<float>(size)) };
+
 		//game items
 		for (int i = 0; i < vec.size(); ++i)
 		{
-			int vecSize = vec[i]->GetSize();
 			//if the size is 0, check on size of item
-			if (size == 0) size = vecSize;
-
-			//get the centers of the items to collision check
-			ThreeBlade checkPos = { pos[0], pos[1], 0 };
-			ThreeBlade itemPos = { vec[i]->GetPos()[0] + vec[i]->GetSize() / 2,
-				vec[i]->GetPos()[1] + vec[i]->GetSize() / 2, 0 };
-
-			//if its a barrier, the y coord is overrated
-			Barrier* barrierExists = dynamic_cast<Barrier*>(vec[i].get());
-			if (barrierExists)
-			{
-				checkPos = { pos[0], 0, 0 };
-				itemPos = { vec[i]->GetPos()[0] + vec[i]->GetSize() / 2,0,0 };
-			}
-			//if its a pickup -> elipse have another center point coord
-			Pickup* pickupExists = dynamic_cast<Pickup*>(vec[i].get());
-			if (pickupExists) itemPos = { vec[i]->GetPos()[0], vec[i]->GetPos()[1], 0 };
-
-			auto bladeDis = itemPos & checkPos;
-			if (abs(bladeDis.Norm()) < static_cast <float>(size / 2 + vecSize / 2))
+			const ConvexShape itemShape{ vec[i]->GetShape() };
+			const bool overlap{ size == 0
+				? collision::Overlap(square(static_cast<float>(vec[i]->GetSize())), itemShape).overlap
+				: collision::Overlap(fixedShape, itemShape).overlap };
+			if (overlap)
 			{
 				hasHit = i;
 			}
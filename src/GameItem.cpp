@@ -1,4 +1,5 @@
 #include "GameItem.h"
+#include <cmath>
 
 void GameItem::Draw() const
 {
@@ -6,6 +7,17 @@ void GameItem::Draw() const
 	utils::FillRect(m_Position[0], m_Position[1], m_Size, m_Size);
 }
 
+ConvexShape GameItem::GetShape() const
+{
+	return ConvexShape::Rectangle(m_Position[0], m_Position[1], static_cast<float>(m_Size), static_cast<float>(m_Size));
+}
+
+Sphere GameItem::GetBounds() const
+{
+	const float halfSize{ m_Size / 2.f };
+	return Sphere{ ThreeBlade{ m_Position[0] + halfSize, m_Position[1] + halfSize, 0 }, halfSize * std::sqrt(2.f) };
+}
+
 void Pillar::ColorPillar()
 {
 	if (m_IsSelected) m_Color = m_SelectedPillarColor;
@@ -18,6 +30,17 @@ void Pickup::Draw() const
 	utils::FillEllipse(m_Position[0], m_Position[1], m_Size, m_Size);
 }
 
+ConvexShape Pickup::GetShape() const
+{
+	//an octagon is close enough to the drawn circle
+	return ConvexShape::RegularPolygon(m_Position, static_cast<float>(m_Size), 8);
+}
+
+Sphere Pickup::GetBounds() const
+{
+	return Sphere{ ThreeBlade{ m_Position[0], m_Position[1], 0 }, static_cast<float>(m_Size) };
+}
+
 void Barrier::Draw() const
 {
 	utils::SetColor(m_Color);
@@ -25,3 +48,15 @@ void Barrier::Draw() const
 
 }
 
+ConvexShape Barrier::GetShape() const
+{
+	return ConvexShape::Rectangle(m_Position[0], m_Position[1], static_cast<float>(m_Size), static_cast<float>(m_Height));
+}
+
+Sphere Barrier::GetBounds() const
+{
+	const float halfWidth{ m_Size / 2.f };
+	const float halfHeight{ m_Height / 2.f };
+	return Sphere{ ThreeBlade{ m_Position[0] + halfWidth, m_Position[1] + halfHeight, 0 },
+		std::sqrt(halfWidth * halfWidth + halfHeight * halfHeight) };
+}
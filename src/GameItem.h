@@ -3,6 +3,8 @@
 #include <memory>
 
 #include "FlyFish.h"
+#include "ConvexShape.h"
+#include "Raycast.h"
 #include "structs.h"
 #include "utils.h"
 
@@ -22,6 +24,10 @@ public:
 	void SetColor(Color4f col) { m_Color = col; }
 	int GetSize() { return m_Size; }
 	virtual void Draw() const;
+	//collision shape, matches what Draw puts on screen
+	virtual ConvexShape GetShape() const;
+	//bounding sphere for culling
+	virtual Sphere GetBounds() const;
 };
 
 class Pillar : public GameItem
@@ -56,6 +62,8 @@ public:
 		m_Color = m_PickupColor;
 	}
 	void Draw() const override;
+	ConvexShape GetShape() const override;
+	Sphere GetBounds() const override;
 	int GetPoints() { return m_Points; }
 };
 
@@ -71,4 +79,6 @@ public:
 		m_Color = m_BarrierColor;
 	}
 	void Draw() const override;
+	ConvexShape GetShape() const override;
+	Sphere GetBounds() const override;
 };
\ No newline at end of file
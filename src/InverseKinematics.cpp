@@ -0,0 +1,231 @@
+#include "InverseKinematics.h"
+
+#include <cmath>
+
+namespace
+{
+    // Rotor scalars below this, within about a tenth of a degree of half a turn, lose their axis to cancellation
+    constexpr float g_TurnedAround{ 1e-3f };
+
+    // Moves every joint in joints to length away from the matching joint in towards, along the line through both
+    void Pull(float* jointX, float* jointY, float* jointZ, const float* towardsX, const float* towardsY, const float* towardsZ,
+        const float* length, size_t count)
+    {
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            const float dx{ jointX[idx] - towardsX[idx] };
+            const float dy{ jointY[idx] - towardsY[idx] };
+            const float dz{ jointZ[idx] - towardsZ[idx] };
+            //the epsilon only keeps coincident joints finite, they stay where they are
+            const float scale{ length[idx] / (std::sqrt(dx * dx + dy * dy + dz * dz) + 1e-30f) };
+            jointX[idx] = towardsX[idx] + dx * scale;
+            jointY[idx] = towardsY[idx] + dy * scale;
+            jointZ[idx] = towardsZ[idx] + dz * scale;
+        }
+    }
+
+    // The joints of the segments of all chains: segment idx runs from joint idx to joint idx + count
+    struct SegmentJoints
+    {
+        const float* x;
+        const float* y;
+        const float* z;
+        size_t count;
+
+        void Direction(size_t idx, float* direction) const
+        {
+            direction[0] = x[idx + count] - x[idx];
+            direction[1] = y[idx + count] - y[idx];
+            direction[2] = z[idx + count] - z[idx];
+            const float length{ 1 / std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]) };
+            for (size_t axis{}; axis < 3; ++axis) direction[axis] *= length;
+        }
+    };
+
+    // Completes the rotor (s, r) in m to T * R, with T moving the rest joint of the segment, turned by R, onto its solved joint
+    void Translate(const SegmentJoints& rest, const SegmentJoints& solved, size_t idx, float* const* m)
+    {
+        const float s{ m[0][idx] }, r1{ m[4][idx] }, r2{ m[5][idx] }, r3{ m[6][idx] };
+
+        //R(q) = q + 2 s (u x q) + 2 u x (u x q) for the quaternion vector part u = -r
+        const float vx{ rest.x[idx] }, vy{ rest.y[idx] }, vz{ rest.z[idx] };
+        const float cx{ s * (-r2 * vz + r3 * vy) }, cy{ s * (-r3 * vx + r1 * vz) }, cz{ s * (-r1 * vy + r2 * vx) };
+        const float ex{ r2 * (r1 * vy - r2 * vx) - r3 * (r3 * vx - r1 * vz) };
+        const float ey{ r3 * (r2 * vz - r3 * vy) - r1 * (r1 * vy - r2 * vx) };
+        const float ez{ r1 * (r3 * vx - r1 * vz) - r2 * (r2 * vz - r3 * vy) };
+
+        //T = (1, a) with a = -t / 2 and t = p - R(q)
+        const float a1{ -(solved.x[idx] - (vx + 2 * cx + 2 * ex)) / 2 };
+        const float a2{ -(solved.y[idx] - (vy + 2 * cy + 2 * ey)) / 2 };
+        const float a3{ -(solved.z[idx] - (vz + 2 * cz + 2 * ez)) / 2 };
+        m[1][idx] = s * a1 - r3 * a2 + r2 * a3;
+        m[2][idx] = r3 * a1 + s * a2 - r1 * a3;
+        m[3][idx] = -r2 * a1 + r1 * a2 + s * a3;
+        m[7][idx] = r1 * a1 + r2 * a2 + r3 * a3;
+    }
+}
+
+IKChains::IKChains(size_t chainCount, size_t jointCount)
+    : m_ChainCount{ chainCount }
+    , m_JointCount{ jointCount }
+    , m_Joints(chainCount * jointCount)
+    , m_RestJoints(chainCount * jointCount)
+    , m_Lengths(chainCount * (jointCount - 1))
+    , m_Reach(chainCount)
+{
+    for (size_t idx{}; idx < m_Joints.Size(); ++idx)
+    {
+        m_Joints.Component(3)[idx] = 1;
+        m_RestJoints.Component(3)[idx] = 1;
+    }
+}
+
+void IKChains::SetChain(size_t chain, const std::vector<ThreeBlade>& joints)
+{
+    for (size_t joint{}; joint < m_JointCount; ++joint)
+    {
+        m_Joints.Set(joint * m_ChainCount + chain, joints[joint]);
+        m_RestJoints.Set(joint * m_ChainCount + chain, joints[joint]);
+    }
+
+    m_Reach[chain] = 0;
+    for (size_t segment{}; segment + 1 < m_JointCount; ++segment)
+    {
+        const ThreeBlade& start{ joints[segment] };
+        const ThreeBlade& end{ joints[segment + 1] };
+        const float dx{ end[0] - start[0] }, dy{ end[1] - start[1] }, dz{ end[2] - start[2] };
+        m_Lengths[segment * m_ChainCount + chain] = std::sqrt(dx * dx + dy * dy + dz * dz);
+        m_Reach[chain] += m_Lengths[segment * m_ChainCount + chain];
+    }
+}
+
+void IKChains::SetAnchor(size_t chain, const ThreeBlade& anchor)
+{
+    m_Joints.Set(chain, anchor);
+}
+
+size_t ik::Solve(IKChains& chains, const PointBatch& targets, const SolveSettings& settings)
+{
+    const size_t count{ chains.ChainCount() };
+    const size_t last{ chains.JointCount() - 1 };
+    if (count == 0 || targets.Size() < count) return 0;
+
+    PointBatch& joints{ chains.Joints() };
+    float* x{ joints.Component(0) };
+    float* y{ joints.Component(1) };
+    float* z{ joints.Component(2) };
+    const float* tx{ targets.Component(0) };
+    const float* ty{ targets.Component(1) };
+    const float* tz{ targets.Component(2) };
+    const float* lengths{ chains.Lengths().data() };
+    const float* reach{ chains.Reach().data() };
+
+    //how far a target lies out of reach, the closest its end joint can get; (a + |a|) / 2 is max(a, 0) without a branch
+    std::vector<float> slack(count);
+    FLYFISH_VECTORIZE
+    for (size_t idx{}; idx < count; ++idx)
+    {
+        const float dx{ tx[idx] - x[idx] }, dy{ ty[idx] - y[idx] }, dz{ tz[idx] - z[idx] };
+        const float over{ std::sqrt(dx * dx + dy * dy + dz * dz) - reach[idx] };
+        slack[idx] = (over + std::fabs(over)) / 2;
+    }
+
+    const float* endX{ x + last * count };
+    const float* endY{ y + last * count };
+    const float* endZ{ z + last * count };
+    const auto worstError = [&]
+        {
+            float worst{};
+            for (size_t idx{}; idx < count; ++idx)
+            {
+                const float dx{ tx[idx] - endX[idx] }, dy{ ty[idx] - endY[idx] }, dz{ tz[idx] - endZ[idx] };
+                worst = std::fmax(worst, std::sqrt(dx * dx + dy * dy + dz * dz) - slack[idx]);
+            }
+            return worst;
+        };
+
+    size_t iteration{};
+    for (; iteration < settings.maxIterations && worstError() > settings.tolerance; ++iteration)
+    {
+        //backward: the end joint onto the target, every joint but the anchor pulled after its child
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            x[last * count + idx] = tx[idx];
+            y[last * count + idx] = ty[idx];
+            z[last * count + idx] = tz[idx];
+        }
+        for (size_t joint{ last - 1 }; joint > 0; --joint)
+        {
+            const size_t at{ joint * count };
+            const size_t child{ at + count };
+            Pull(x + at, y + at, z + at, x + child, y + child, z + child, lengths + at, count);
+        }
+
+        //forward: from the anchor out, every joint pulled after its parent
+        for (size_t joint{ 1 }; joint <= last; ++joint)
+        {
+            const size_t at{ joint * count };
+            const size_t parent{ at - count };
+            Pull(x + at, y + at, z + at, x + parent, y + parent, z + parent, lengths + parent, count);
+        }
+    }
+    return iteration;
+}
+
+void ik::SegmentMotors(const IKChains& chains, MotorBatch& out)
+{
+    const size_t count{ chains.ChainCount() };
+    const size_t segments{ count * (chains.JointCount() - 1) };
+    out.Resize(segments);
+
+    const PointBatch& joints{ chains.Joints() };
+    const PointBatch& rest{ chains.RestJoints() };
+    const SegmentJoints solved{ joints.Component(0), joints.Component(1), joints.Component(2), count };
+    const SegmentJoints resting{ rest.Component(0), rest.Component(1), rest.Component(2), count };
+    float* m[8]{};
+    for (size_t component{}; component < 8; ++component) m[component] = out.Component(component);
+
+    FLYFISH_VECTORIZE
+    for (size_t idx{}; idx < segments; ++idx)
+    {
+        float a[3]{}, b[3]{};
+        resting.Direction(idx, a);
+        solved.Direction(idx, b);
+
+        //the quaternion (1 + a . b, a x b) halves the angle from a to b, FlyFish stores its vector part negated.
+        //The epsilon keeps segments turned around finite, the pass below replaces them
+        const float w{ 1 + a[0] * b[0] + a[1] * b[1] + a[2] * b[2] };
+        const float ux{ a[1] * b[2] - a[2] * b[1] };
+        const float uy{ a[2] * b[0] - a[0] * b[2] };
+        const float uz{ a[0] * b[1] - a[1] * b[0] };
+        const float norm{ 1 / std::sqrt(w * w + ux * ux + uy * uy + uz * uz + 1e-30f) };
+        m[0][idx] = w * norm;
+        m[4][idx] = -ux * norm;
+        m[5][idx] = -uy * norm;
+        m[6][idx] = -uz * norm;
+    }
+
+    //turned around there is no shortest rotation, any half turn about a perpendicular of a will do.
+    //A separate scalar pass, the selects it needs keep GCC from vectorizing the loop above
+    for (size_t idx{}; idx < segments; ++idx)
+    {
+        if (m[0][idx] >= g_TurnedAround) continue;
+        float a[3]{};
+        resting.Direction(idx, a);
+
+        //built from the two larger components of a
+        const bool xSmall{ std::fabs(a[0]) < 0.5f };
+        const float ux{ xSmall ? 0 : a[2] };
+        const float uy{ xSmall ? -a[2] : 0 };
+        const float uz{ xSmall ? a[1] : -a[0] };
+        const float norm{ 1 / std::sqrt(ux * ux + uy * uy + uz * uz) };
+        m[0][idx] = 0;
+        m[4][idx] = -ux * norm;
+        m[5][idx] = -uy * norm;
+        m[6][idx] = -uz * norm;
+    }
+
+    FLYFISH_VECTORIZE
+    for (size_t idx{}; idx < segments; ++idx) Translate(resting, solved, idx, m);
+}
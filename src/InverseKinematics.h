@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Independent chains of joints, all with the same joint count, solved together.
+// Joint j of chain c is stored at j * ChainCount() + c, so every sweep over one joint is a single
+// vectorized loop over all chains. Joint 0 is the anchor: the solver never moves it, SetAnchor does.
+class IKChains
+{
+public:
+    IKChains() = default;
+    // jointCount is at least 2, every joint starts at the origin until SetChain
+    IKChains(size_t chainCount, size_t jointCount);
+
+    [[nodiscard]] size_t ChainCount() const { return m_ChainCount; }
+    [[nodiscard]] size_t JointCount() const { return m_JointCount; }
+
+    // JointCount() points giving the rest pose of chain, the segment lengths follow from it and the joints start there
+    void SetChain(size_t chain, const std::vector<ThreeBlade>& joints);
+    void SetAnchor(size_t chain, const ThreeBlade& anchor);
+
+    [[nodiscard]] ThreeBlade Joint(size_t chain, size_t joint) const { return m_Joints.Get(joint * m_ChainCount + chain); }
+    [[nodiscard]] const PointBatch& Joints() const { return m_Joints; }
+    [[nodiscard]] PointBatch& Joints() { return m_Joints; }
+    [[nodiscard]] const PointBatch& RestJoints() const { return m_RestJoints; }
+    // Segment s of chain c at s * ChainCount() + c
+    [[nodiscard]] const std::vector<float>& Lengths() const { return m_Lengths; }
+    // Sum of the segment lengths per chain
+    [[nodiscard]] const std::vector<float>& Reach() const { return m_Reach; }
+
+private:
+    size_t m_ChainCount{};
+    size_t m_JointCount{};
+    PointBatch m_Joints{};
+    PointBatch m_RestJoints{};
+    std::vector<float> m_Lengths{};
+    std::vector<float> m_Reach{};
+};
+
+namespace ik
+{
+    struct SolveSettings
+    {
+        // Upper bound on the backward and forward sweeps per call, which bounds the cost per frame
+        size_t maxIterations{ 10 };
+        // Done once every end joint is this close to its target, or as close as its reach allows
+        float tolerance{ 1e-3f };
+    };
+
+    // FABRIK: pulls the last joint of every chain towards targets[chain], keeping the anchors and segment lengths.
+    // targets holds one point per chain; joints and targets are expected to have weight 1. Returns the number of sweeps used,
+    // 0 when the chains were already solved or targets is too short.
+    size_t Solve(IKChains& chains, const PointBatch& targets, const SolveSettings& settings);
+
+    // out[segment * ChainCount() + chain] takes the segment from its rest pose to its solved pose: the shortest
+    // rotation turning the rest direction into the solved one, then the translation onto the solved joint.
+    // Skinning geometry attached to the segments with these motors keeps it on the chain.
+    void SegmentMotors(const IKChains& chains, MotorBatch& out);
+}
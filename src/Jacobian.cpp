@@ -0,0 +1,293 @@
+#include "Jacobian.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Skinning.h"
+
+namespace
+{
+    // Pairs summed in float lanes before being flushed into the double totals
+    constexpr size_t g_LaneCount{ 8 };
+    constexpr size_t g_FlushSize{ 256 };
+
+    // For a fixed motor the sandwich is an affine map, rows of x' = a x + b y + c z + d w
+    struct AffineMap
+    {
+        float rows[3][4];
+    };
+
+    AffineMap ToAffineMap(const Motor& motor)
+    {
+        AffineMap map{};
+        for (int column{}; column < 4; ++column)
+        {
+            ThreeBlade basis{ 0, 0, 0, 0 };
+            basis[column] = 1;
+            const ThreeBlade image{ skinning::Transform(motor, basis) };
+            for (int row{}; row < 3; ++row) map.rows[row][column] = image[row];
+        }
+        return map;
+    }
+
+    // Writes the 3x6 derivative of the moved point (x, y, z) row after row
+    void FillDerivative(float x, float y, float z, float* derivative)
+    {
+        const float values[3][6]{
+            { -2, 0, 0, 0, -2 * z, 2 * y },
+            { 0, -2, 0, 2 * z, 0, -2 * x },
+            { 0, 0, -2, -2 * y, 2 * x, 0 } };
+        for (int row{}; row < 3; ++row)
+        {
+            for (int column{}; column < 6; ++column) derivative[row * 6 + column] = values[row][column];
+        }
+    }
+
+    // Cholesky on the symmetric positive definite 6x6 system, false on a non positive pivot
+    bool SolveSymmetric(double matrix[6][6], double vector[6])
+    {
+        for (int column{}; column < 6; ++column)
+        {
+            double pivot{ matrix[column][column] };
+            for (int k{}; k < column; ++k) pivot -= matrix[column][k] * matrix[column][k];
+            if (!(pivot > 0)) return false;
+            matrix[column][column] = std::sqrt(pivot);
+            for (int row{ column + 1 }; row < 6; ++row)
+            {
+                double value{ matrix[row][column] };
+                for (int k{}; k < column; ++k) value -= matrix[row][k] * matrix[column][k];
+                matrix[row][column] = value / matrix[column][column];
+            }
+        }
+        for (int row{}; row < 6; ++row)
+        {
+            for (int k{}; k < row; ++k) vector[row] -= matrix[row][k] * vector[k];
+            vector[row] /= matrix[row][row];
+        }
+        for (int row{ 5 }; row >= 0; --row)
+        {
+            for (int k{ row + 1 }; k < 6; ++k) vector[row] -= matrix[k][row] * vector[k];
+            vector[row] /= matrix[row][row];
+        }
+        return true;
+    }
+}
+
+void NormalEquations::Clear()
+{
+    *this = NormalEquations{};
+}
+
+namespace jacobian
+{
+    SandwichJacobian Transform(const Motor& motor, const ThreeBlade& point)
+    {
+        const ThreeBlade moved{ skinning::Transform(motor, point) };
+        SandwichJacobian result{ moved, {} };
+        FillDerivative(moved[0] / moved[3], moved[1] / moved[3], moved[2] / moved[3], &result.derivative[0][0]);
+        return result;
+    }
+
+    void Transform(const Motor& motor, const PointBatch& points, PointBatch& out, std::vector<float>& derivatives)
+    {
+        const size_t count{ points.Size() };
+        out.Resize(count);
+        derivatives.resize(count * 18);
+
+        const AffineMap map{ ToAffineMap(motor) };
+        const float* x{ points.Component(0) };
+        const float* y{ points.Component(1) };
+        const float* z{ points.Component(2) };
+        const float* w{ points.Component(3) };
+        float* outX{ out.Component(0) };
+        float* outY{ out.Component(1) };
+        float* outZ{ out.Component(2) };
+        float* outW{ out.Component(3) };
+
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            outX[idx] = map.rows[0][0] * x[idx] + map.rows[0][1] * y[idx] + map.rows[0][2] * z[idx] + map.rows[0][3] * w[idx];
+            outY[idx] = map.rows[1][0] * x[idx] + map.rows[1][1] * y[idx] + map.rows[1][2] * z[idx] + map.rows[1][3] * w[idx];
+            outZ[idx] = map.rows[2][0] * x[idx] + map.rows[2][1] * y[idx] + map.rows[2][2] * z[idx] + map.rows[2][3] * w[idx];
+            outW[idx] = w[idx];
+        }
+
+        //interleaved per point, so this part stays scalar
+        float* derivative{ derivatives.data() };
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            FillDerivative(outX[idx] / outW[idx], outY[idx] / outW[idx], outZ[idx] / outW[idx], derivative);
+            derivative += 18;
+        }
+    }
+
+    void AccumulatePointToPoint(const Motor& motor, const PointBatch& from, const PointBatch& to, NormalEquations& equations)
+    {
+        const size_t count{ std::min(from.Size(), to.Size()) };
+        if (count == 0) return;
+
+        const AffineMap map{ ToAffineMap(motor) };
+        const float* fx{ from.Component(0) };
+        const float* fy{ from.Component(1) };
+        const float* fz{ from.Component(2) };
+        const float* fw{ from.Component(3) };
+        const float* tx{ to.Component(0) };
+        const float* ty{ to.Component(1) };
+        const float* tz{ to.Component(2) };
+        const float* tw{ to.Component(3) };
+        const float m00{ map.rows[0][0] }, m01{ map.rows[0][1] }, m02{ map.rows[0][2] }, m03{ map.rows[0][3] };
+        const float m10{ map.rows[1][0] }, m11{ map.rows[1][1] }, m12{ map.rows[1][2] }, m13{ map.rows[1][3] };
+        const float m20{ map.rows[2][0] }, m21{ map.rows[2][1] }, m22{ map.rows[2][2] }, m23{ map.rows[2][3] };
+
+        //moved points are summed relative to the first one, which keeps the float sums small.
+        //The derivatives are linear in p', so the absolute sums are put back together in double.
+        const ThreeBlade reference{ skinning::Transform(motor, from.Get(0)) };
+        const float cx{ reference[0] / reference[3] }, cy{ reference[1] / reference[3] }, cz{ reference[2] / reference[3] };
+
+        //d, d d^T, r, r x d and |r|^2
+        double totals[16]{};
+        for (size_t block{}; block < count; block += g_FlushSize)
+        {
+            const size_t blockEnd{ std::min(block + g_FlushSize, count) };
+
+            float sums[16][g_LaneCount]{};
+            size_t idx{ block };
+            for (; idx + g_LaneCount <= blockEnd; idx += g_LaneCount)
+            {
+                FLYFISH_VECTORIZE
+                for (size_t lane{}; lane < g_LaneCount; ++lane)
+                {
+                    const size_t pair{ idx + lane };
+                    const float x{ fx[pair] }, y{ fy[pair] }, z{ fz[pair] }, w{ fw[pair] };
+                    const float px{ (m00 * x + m01 * y + m02 * z + m03 * w) / w };
+                    const float py{ (m10 * x + m11 * y + m12 * z + m13 * w) / w };
+                    const float pz{ (m20 * x + m21 * y + m22 * z + m23 * w) / w };
+                    const float rx{ px - tx[pair] / tw[pair] }, ry{ py - ty[pair] / tw[pair] }, rz{ pz - tz[pair] / tw[pair] };
+                    const float dx{ px - cx }, dy{ py - cy }, dz{ pz - cz };
+                    sums[0][lane] += dx;
+                    sums[1][lane] += dy;
+                    sums[2][lane] += dz;
+                    sums[3][lane] += dx * dx;
+                    sums[4][lane] += dx * dy;
+                    sums[5][lane] += dx * dz;
+                    sums[6][lane] += dy * dy;
+                    sums[7][lane] += dy * dz;
+                    sums[8][lane] += dz * dz;
+                    sums[9][lane] += rx;
+                    sums[10][lane] += ry;
+                    sums[11][lane] += rz;
+                    sums[12][lane] += ry * dz - rz * dy;
+                    sums[13][lane] += rz * dx - rx * dz;
+                    sums[14][lane] += rx * dy - ry * dx;
+                    sums[15][lane] += rx * rx + ry * ry + rz * rz;
+                }
+            }
+
+            for (size_t sum{}; sum < 16; ++sum)
+            {
+                for (size_t lane{}; lane < g_LaneCount; ++lane) totals[sum] += sums[sum][lane];
+            }
+            for (; idx < blockEnd; ++idx)
+            {
+                const double x{ fx[idx] }, y{ fy[idx] }, z{ fz[idx] }, w{ fw[idx] };
+                const double px{ (m00 * x + m01 * y + m02 * z + m03 * w) / w };
+                const double py{ (m10 * x + m11 * y + m12 * z + m13 * w) / w };
+                const double pz{ (m20 * x + m21 * y + m22 * z + m23 * w) / w };
+                const double rx{ px - tx[idx] / tw[idx] }, ry{ py - ty[idx] / tw[idx] }, rz{ pz - tz[idx] / tw[idx] };
+                const double dx{ px - cx }, dy{ py - cy }, dz{ pz - cz };
+                totals[0] += dx;
+                totals[1] += dy;
+                totals[2] += dz;
+                totals[3] += dx * dx;
+                totals[4] += dx * dy;
+                totals[5] += dx * dz;
+                totals[6] += dy * dy;
+                totals[7] += dy * dz;
+                totals[8] += dz * dz;
+                totals[9] += rx;
+                totals[10] += ry;
+                totals[11] += rz;
+                totals[12] += ry * dz - rz * dy;
+                totals[13] += rz * dx - rx * dz;
+                totals[14] += rx * dy - ry * dx;
+                totals[15] += rx * rx + ry * ry + rz * rz;
+            }
+        }
+
+        //p = c + d, sum p and sum p p^T around the origin again
+        const double n{ static_cast<double>(count) };
+        const double c[3]{ cx, cy, cz };
+        const double sumD[3]{ totals[0], totals[1], totals[2] };
+        const double sumDD[3][3]{
+            { totals[3], totals[4], totals[5] },
+            { totals[4], totals[6], totals[7] },
+            { totals[5], totals[7], totals[8] } };
+        const double sumR[3]{ totals[9], totals[10], totals[11] };
+
+        double sumP[3]{}, sumPP[3][3]{};
+        for (int row{}; row < 3; ++row)
+        {
+            sumP[row] = n * c[row] + sumD[row];
+            for (int column{}; column < 3; ++column)
+            {
+                sumPP[row][column] = n * c[row] * c[column] + c[row] * sumD[column] + sumD[row] * c[column] + sumDD[row][column];
+            }
+        }
+        //sum r x p = (sum r) x c + sum r x d
+        const double sumRxP[3]{
+            sumR[1] * c[2] - sumR[2] * c[1] + totals[12],
+            sumR[2] * c[0] - sumR[0] * c[2] + totals[13],
+            sumR[0] * c[1] - sumR[1] * c[0] + totals[14] };
+
+        //J = [-2 I | 2 [p']x], see FillDerivative
+        const double trace{ sumPP[0][0] + sumPP[1][1] + sumPP[2][2] };
+        const double coupling[3][3]{
+            { 0, 4 * sumP[2], -4 * sumP[1] },
+            { -4 * sumP[2], 0, 4 * sumP[0] },
+            { 4 * sumP[1], -4 * sumP[0], 0 } };
+        for (int row{}; row < 3; ++row)
+        {
+            equations.hessian[row][row] += 4 * n;
+            for (int column{}; column < 3; ++column)
+            {
+                equations.hessian[row][3 + column] += coupling[row][column];
+                equations.hessian[3 + column][row] += coupling[row][column];
+                equations.hessian[3 + row][3 + column] += 4 * ((row == column ? trace : 0) - sumPP[row][column]);
+            }
+            equations.gradient[row] += -2 * sumR[row];
+            equations.gradient[3 + row] += 2 * sumRxP[row];
+        }
+        equations.cost += totals[15];
+        equations.count += count;
+    }
+
+    bool SolveStep(const NormalEquations& equations, float damping, float step[6])
+    {
+        double matrix[6][6]{}, vector[6]{};
+        for (int row{}; row < 6; ++row)
+        {
+            for (int column{}; column < 6; ++column) matrix[row][column] = equations.hessian[row][column];
+            matrix[row][row] *= 1 + damping;
+            vector[row] = -equations.gradient[row];
+        }
+        if (!SolveSymmetric(matrix, vector)) return false;
+        for (int idx{}; idx < 6; ++idx) step[idx] = static_cast<float>(vector[idx]);
+        return true;
+    }
+
+    Motor ApplyStep(const Motor& motor, const float step[6])
+    {
+        const Motor delta{ 1, step[0], step[1], step[2], step[3], step[4], step[5], 0 };
+        return skinning::Renormalize(delta * motor);
+    }
+
+    Motor GaussNewtonStep(const Motor& motor, const PointBatch& from, const PointBatch& to, float damping)
+    {
+        NormalEquations equations{};
+        AccumulatePointToPoint(motor, from, to, equations);
+        float step[6]{};
+        if (!SolveStep(equations, damping, step)) return motor;
+        return ApplyStep(motor, step);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Derivatives are taken with respect to a bivector step applied in front of the motor,
+// (1 + step) * motor with step = (e01, e02, e03, e23, e31, e12) in FlyFish component order.
+// For the moved point p' = (motor * p * ~motor).Grade3() that gives
+// dp'/de0i = -2 e_i and dp'/de_jk = 2 p' x e_i, with e_i the axis e_jk turns around (e23 -> e1).
+// Both only depend on p' itself.
+struct SandwichJacobian
+{
+    ThreeBlade point;
+    // derivative[axis][parameter] of the normalized x, y, z of point
+    float derivative[3][6];
+};
+
+// Gauss-Newton normal equations of the point to point residuals p' - q, summed over every added pair
+struct NormalEquations
+{
+    double hessian[6][6]{};
+    double gradient[6]{};
+    double cost{};
+    size_t count{};
+
+    void Clear();
+};
+
+namespace jacobian
+{
+    [[nodiscard]] SandwichJacobian Transform(const Motor& motor, const ThreeBlade& point);
+
+    // out[i] is the moved point, derivatives holds 18 floats per point laid out like SandwichJacobian::derivative
+    void Transform(const Motor& motor, const PointBatch& points, PointBatch& out, std::vector<float>& derivatives);
+
+    // Moves from through motor and adds the residuals against to, with their derivatives, to equations.
+    // One pass over both batches, the shorter one decides the count.
+    void AccumulatePointToPoint(const Motor& motor, const PointBatch& from, const PointBatch& to, NormalEquations& equations);
+
+    // Solves (H + damping diag(H)) step = -g, false when the system is singular
+    [[nodiscard]] bool SolveStep(const NormalEquations& equations, float damping, float step[6]);
+
+    // (1 + step) * motor projected back onto the rigid motions
+    [[nodiscard]] Motor ApplyStep(const Motor& motor, const float step[6]);
+
+    // One accumulate, solve and apply round, motor is returned unchanged when the step cannot be solved
+    [[nodiscard]] Motor GaussNewtonStep(const Motor& motor, const PointBatch& from, const PointBatch& to, float damping = 0);
+}
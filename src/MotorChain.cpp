@@ -0,0 +1,72 @@
+#include "MotorChain.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "Skinning.h"
+
+namespace
+{
+    const Motor g_Identity{ 1, 0, 0, 0, 0, 0, 0, 0 };
+}
+
+MotorChain::MotorChain(const std::vector<Motor>& factors)
+{
+    size_t capacity{ 1 };
+    while (capacity < factors.size()) capacity *= 2;
+    m_Size = factors.size();
+    m_Tree.assign(capacity * 2, g_Identity);
+    std::copy(factors.begin(), factors.end(), m_Tree.begin() + capacity);
+    Rebuild(capacity);
+}
+
+void MotorChain::Set(size_t idx, const Motor& factor)
+{
+    size_t node{ m_Capacity + idx };
+    m_Tree[node] = factor;
+    for (node /= 2; node > 0; node /= 2) m_Tree[node] = m_Tree[node * 2] * m_Tree[node * 2 + 1];
+}
+
+void MotorChain::PushBack(const Motor& factor)
+{
+    //doubling rebuilds every node once, so a push is amortized O(1) products on top of the O(log n) path
+    if (m_Size == m_Capacity)
+    {
+        std::vector<Motor> tree(m_Capacity * 4, g_Identity);
+        std::copy(m_Tree.begin() + m_Capacity, m_Tree.begin() + m_Capacity + m_Size, tree.begin() + m_Capacity * 2);
+        m_Tree = std::move(tree);
+        Rebuild(m_Capacity * 2);
+    }
+    Set(m_Size++, factor);
+}
+
+void MotorChain::Clear()
+{
+    m_Size = 0;
+    m_Capacity = 1;
+    m_Tree.assign(2, g_Identity);
+}
+
+Motor MotorChain::Product(size_t first, size_t last) const
+{
+    //left and right runs grow inward, which keeps the factors in order
+    Motor left{ g_Identity };
+    Motor right{ g_Identity };
+    for (size_t low{ first + m_Capacity }, high{ last + m_Capacity }; low < high; low /= 2, high /= 2)
+    {
+        if (low & 1) left = left * m_Tree[low++];
+        if (high & 1) right = m_Tree[--high] * right;
+    }
+    return left * right;
+}
+
+void MotorChain::Apply(const PointBatch& points, PointBatch& out) const
+{
+    skinning::TransformPoints(Total(), points, out);
+}
+
+void MotorChain::Rebuild(size_t capacity)
+{
+    m_Capacity = capacity;
+    for (size_t node{ capacity - 1 }; node > 0; --node) m_Tree[node] = m_Tree[node * 2] * m_Tree[node * 2 + 1];
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Product F0 * F1 * ... * Fn-1 of a sequence of motors, F0 being the outermost (last applied) factor.
+// Every partial product of an aligned power of two run is cached in a segment tree, so replacing one factor
+// recomposes log2(n) products instead of n, and any run, prefixes and suffixes included, costs at most 2 log2(n).
+class MotorChain
+{
+public:
+    MotorChain() = default;
+    explicit MotorChain(const std::vector<Motor>& factors);
+
+    [[nodiscard]] size_t Size() const { return m_Size; }
+    [[nodiscard]] const Motor& Factor(size_t idx) const { return m_Tree[m_Capacity + idx]; }
+
+    void Set(size_t idx, const Motor& factor);
+    void PushBack(const Motor& factor);
+    void Clear();
+
+    // The whole product, already composed
+    [[nodiscard]] const Motor& Total() const { return m_Tree[1]; }
+    // F[first] * ... * F[last - 1], the identity for an empty run
+    [[nodiscard]] Motor Product(size_t first, size_t last) const;
+
+    // out[i] = Total() applied to points[i], out is resized to points.Size()
+    void Apply(const PointBatch& points, PointBatch& out) const;
+
+private:
+    void Rebuild(size_t capacity);
+
+    size_t m_Size{};
+    size_t m_Capacity{ 1 };
+    // Node i holds node 2i * node 2i + 1, the factors are the leaves from m_Capacity on
+    std::vector<Motor> m_Tree{ 2, Motor{ 1, 0, 0, 0, 0, 0, 0, 0 } };
+};
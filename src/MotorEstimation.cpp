@@ -0,0 +1,365 @@
+#include "MotorEstimation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Pairs summed in float lanes before being flushed into the double totals
+    constexpr size_t g_LaneCount{ 8 };
+    constexpr size_t g_FlushSize{ 256 };
+
+    // Cyclic Jacobi rotations on a symmetric 4x4 matrix, returns the eigenvector of the largest eigenvalue
+    void LargestEigenvector(double matrix[4][4], double vector[4])
+    {
+        double vectors[4][4]{ { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+
+        //converged once the off diagonal part is negligible next to the whole matrix
+        double magnitude{};
+        for (int row{}; row < 4; ++row)
+        {
+            for (int column{}; column < 4; ++column) magnitude += matrix[row][column] * matrix[row][column];
+        }
+
+        for (int sweep{}; sweep < 32; ++sweep)
+        {
+            double offDiagonal{};
+            for (int row{}; row < 4; ++row)
+            {
+                for (int column{ row + 1 }; column < 4; ++column) offDiagonal += matrix[row][column] * matrix[row][column];
+            }
+            if (offDiagonal <= 1e-24 * magnitude) break;
+
+            for (int p{}; p < 4; ++p)
+            {
+                for (int q{ p + 1 }; q < 4; ++q)
+                {
+                    if (matrix[p][q] == 0) continue;
+
+                    const double theta{ (matrix[q][q] - matrix[p][p]) / (2 * matrix[p][q]) };
+                    const double t{ (theta >= 0 ? 1 : -1) / (std::fabs(theta) + std::sqrt(theta * theta + 1)) };
+                    const double c{ 1 / std::sqrt(t * t + 1) };
+                    const double s{ t * c };
+
+                    for (int k{}; k < 4; ++k)
+                    {
+                        const double kp{ matrix[k][p] }, kq{ matrix[k][q] };
+                        matrix[k][p] = c * kp - s * kq;
+                        matrix[k][q] = s * kp + c * kq;
+                    }
+                    for (int k{}; k < 4; ++k)
+                    {
+                        const double pk{ matrix[p][k] }, qk{ matrix[q][k] };
+                        matrix[p][k] = c * pk - s * qk;
+                        matrix[q][k] = s * pk + c * qk;
+                    }
+                    for (int k{}; k < 4; ++k)
+                    {
+                        const double kp{ vectors[k][p] }, kq{ vectors[k][q] };
+                        vectors[k][p] = c * kp - s * kq;
+                        vectors[k][q] = s * kp + c * kq;
+                    }
+                }
+            }
+        }
+
+        int largest{};
+        for (int idx{ 1 }; idx < 4; ++idx)
+        {
+            if (matrix[idx][idx] > matrix[largest][largest]) largest = idx;
+        }
+        for (int idx{}; idx < 4; ++idx) vector[idx] = vectors[idx][largest];
+    }
+
+    double Determinant3(double a, double b, double c, double d, double e, double f, double g, double h, double i)
+    {
+        return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    }
+
+    // Horn's matrix is symmetric and traceless, its characteristic polynomial is
+    // x^4 - tr(N^2)/2 x^2 - tr(N^3)/3 x + det(N). Newton from the Frobenius norm, an upper bound,
+    // walks down onto the largest root, and a column of the adjugate of N - x I is its eigenvector.
+    // Falls back to Jacobi when the top eigenvalue is (nearly) repeated and the adjugate vanishes.
+    void TopEigenvector(double matrix[4][4], double vector[4])
+    {
+        double squared[4][4]{};
+        for (int row{}; row < 4; ++row)
+        {
+            for (int column{}; column < 4; ++column)
+            {
+                for (int k{}; k < 4; ++k) squared[row][column] += matrix[row][k] * matrix[k][column];
+            }
+        }
+        double trace2{}, trace3{};
+        for (int row{}; row < 4; ++row)
+        {
+            trace2 += squared[row][row];
+            for (int k{}; k < 4; ++k) trace3 += squared[row][k] * matrix[k][row];
+        }
+        if (trace2 == 0)
+        {
+            vector[0] = 1;
+            vector[1] = vector[2] = vector[3] = 0;
+            return;
+        }
+
+        double determinant{};
+        for (int column{}; column < 4; ++column)
+        {
+            int other[3]{}, count{};
+            for (int k{}; k < 4; ++k) if (k != column) other[count++] = k;
+            const double minor{ Determinant3(
+                matrix[1][other[0]], matrix[1][other[1]], matrix[1][other[2]],
+                matrix[2][other[0]], matrix[2][other[1]], matrix[2][other[2]],
+                matrix[3][other[0]], matrix[3][other[1]], matrix[3][other[2]]) };
+            determinant += (column % 2 == 0 ? 1 : -1) * matrix[0][column] * minor;
+        }
+
+        const double c2{ -trace2 / 2 }, c1{ -trace3 / 3 }, c0{ determinant };
+        double x{ std::sqrt(trace2) };
+        for (int iteration{}; iteration < 50; ++iteration)
+        {
+            const double value{ ((x * x + c2) * x + c1) * x + c0 };
+            const double slope{ (4 * x * x + 2 * c2) * x + c1 };
+            if (slope == 0) break;
+            const double step{ value / slope };
+            x -= step;
+            if (std::fabs(step) <= 1e-12 * std::fabs(x)) break;
+        }
+
+        double shifted[4][4]{};
+        for (int row{}; row < 4; ++row)
+        {
+            for (int column{}; column < 4; ++column) shifted[row][column] = matrix[row][column] - (row == column ? x : 0);
+        }
+
+        //shifted is symmetric, so its adjugate is too and rows serve as well as columns
+        double best{};
+        for (int row{}; row < 4; ++row)
+        {
+            int rows[3]{}, rowCount{};
+            for (int k{}; k < 4; ++k) if (k != row) rows[rowCount++] = k;
+
+            double cofactors[4]{};
+            double length{};
+            for (int column{}; column < 4; ++column)
+            {
+                int columns[3]{}, columnCount{};
+                for (int k{}; k < 4; ++k) if (k != column) columns[columnCount++] = k;
+                cofactors[column] = ((row + column) % 2 == 0 ? 1 : -1) * Determinant3(
+                    shifted[rows[0]][columns[0]], shifted[rows[0]][columns[1]], shifted[rows[0]][columns[2]],
+                    shifted[rows[1]][columns[0]], shifted[rows[1]][columns[1]], shifted[rows[1]][columns[2]],
+                    shifted[rows[2]][columns[0]], shifted[rows[2]][columns[1]], shifted[rows[2]][columns[2]]);
+                length += cofactors[column] * cofactors[column];
+            }
+            if (length > best)
+            {
+                best = length;
+                for (int k{}; k < 4; ++k) vector[k] = cofactors[k];
+            }
+        }
+
+        //the adjugate scales with the cube of the matrix, compare against that
+        if (best <= 1e-20 * trace2 * trace2 * trace2) LargestEigenvector(matrix, vector);
+    }
+}
+
+void MotorFitter::SetReference(float fromX, float fromY, float fromZ, float toX, float toY, float toZ)
+{
+    m_FromReference[0] = fromX;
+    m_FromReference[1] = fromY;
+    m_FromReference[2] = fromZ;
+    m_ToReference[0] = toX;
+    m_ToReference[1] = toY;
+    m_ToReference[2] = toZ;
+}
+
+void MotorFitter::Add(const ThreeBlade& from, const ThreeBlade& to)
+{
+    const float fromPoint[3]{ from[0] / from[3], from[1] / from[3], from[2] / from[3] };
+    const float toPoint[3]{ to[0] / to[3], to[1] / to[3], to[2] / to[3] };
+    if (m_Count == 0) SetReference(fromPoint[0], fromPoint[1], fromPoint[2], toPoint[0], toPoint[1], toPoint[2]);
+
+    double p[3]{}, q[3]{};
+    for (size_t axis{}; axis < 3; ++axis)
+    {
+        p[axis] = fromPoint[axis] - m_FromReference[axis];
+        q[axis] = toPoint[axis] - m_ToReference[axis];
+        m_From[axis] += p[axis];
+        m_To[axis] += q[axis];
+    }
+    for (size_t row{}; row < 3; ++row)
+    {
+        for (size_t column{}; column < 3; ++column) m_Cross[row][column] += p[row] * q[column];
+    }
+    ++m_Count;
+}
+
+void MotorFitter::Add(const PointBatch& from, const PointBatch& to, size_t first, size_t count)
+{
+    if (count == 0) return;
+    if (m_Count == 0)
+    {
+        const ThreeBlade fromPoint{ from.Get(first) };
+        const ThreeBlade toPoint{ to.Get(first) };
+        SetReference(fromPoint[0] / fromPoint[3], fromPoint[1] / fromPoint[3], fromPoint[2] / fromPoint[3],
+            toPoint[0] / toPoint[3], toPoint[1] / toPoint[3], toPoint[2] / toPoint[3]);
+    }
+
+    const float* fx{ from.Component(0) + first };
+    const float* fy{ from.Component(1) + first };
+    const float* fz{ from.Component(2) + first };
+    const float* fw{ from.Component(3) + first };
+    const float* tx{ to.Component(0) + first };
+    const float* ty{ to.Component(1) + first };
+    const float* tz{ to.Component(2) + first };
+    const float* tw{ to.Component(3) + first };
+    const float rfx{ m_FromReference[0] }, rfy{ m_FromReference[1] }, rfz{ m_FromReference[2] };
+    const float rtx{ m_ToReference[0] }, rty{ m_ToReference[1] }, rtz{ m_ToReference[2] };
+
+    for (size_t block{}; block < count; block += g_FlushSize)
+    {
+        const size_t blockEnd{ std::min(block + g_FlushSize, count) };
+
+        //one partial sum per lane, so the loop vectorizes without reassociating a reduction
+        float sums[15][g_LaneCount]{};
+        size_t idx{ block };
+        for (; idx + g_LaneCount <= blockEnd; idx += g_LaneCount)
+        {
+            FLYFISH_VECTORIZE
+            for (size_t lane{}; lane < g_LaneCount; ++lane)
+            {
+                const size_t pair{ idx + lane };
+                const float px{ fx[pair] / fw[pair] - rfx }, py{ fy[pair] / fw[pair] - rfy }, pz{ fz[pair] / fw[pair] - rfz };
+                const float qx{ tx[pair] / tw[pair] - rtx }, qy{ ty[pair] / tw[pair] - rty }, qz{ tz[pair] / tw[pair] - rtz };
+                sums[0][lane] += px;
+                sums[1][lane] += py;
+                sums[2][lane] += pz;
+                sums[3][lane] += qx;
+                sums[4][lane] += qy;
+                sums[5][lane] += qz;
+                sums[6][lane] += px * qx;
+                sums[7][lane] += px * qy;
+                sums[8][lane] += px * qz;
+                sums[9][lane] += py * qx;
+                sums[10][lane] += py * qy;
+                sums[11][lane] += py * qz;
+                sums[12][lane] += pz * qx;
+                sums[13][lane] += pz * qy;
+                sums[14][lane] += pz * qz;
+            }
+        }
+
+        double totals[15]{};
+        for (size_t sum{}; sum < 15; ++sum)
+        {
+            for (size_t lane{}; lane < g_LaneCount; ++lane) totals[sum] += sums[sum][lane];
+        }
+        for (; idx < blockEnd; ++idx)
+        {
+            const double p[3]{ fx[idx] / fw[idx] - rfx, fy[idx] / fw[idx] - rfy, fz[idx] / fw[idx] - rfz };
+            const double q[3]{ tx[idx] / tw[idx] - rtx, ty[idx] / tw[idx] - rty, tz[idx] / tw[idx] - rtz };
+            for (size_t axis{}; axis < 3; ++axis)
+            {
+                totals[axis] += p[axis];
+                totals[3 + axis] += q[axis];
+            }
+            for (size_t row{}; row < 3; ++row)
+            {
+                for (size_t column{}; column < 3; ++column) totals[6 + row * 3 + column] += p[row] * q[column];
+            }
+        }
+
+        for (size_t axis{}; axis < 3; ++axis)
+        {
+            m_From[axis] += totals[axis];
+            m_To[axis] += totals[3 + axis];
+        }
+        for (size_t row{}; row < 3; ++row)
+        {
+            for (size_t column{}; column < 3; ++column) m_Cross[row][column] += totals[6 + row * 3 + column];
+        }
+    }
+    m_Count += count;
+}
+
+void MotorFitter::Clear()
+{
+    *this = MotorFitter{};
+}
+
+Motor MotorFitter::Solve() const
+{
+    if (m_Count == 0) return Motor{ 1, 0, 0, 0, 0, 0, 0, 0 };
+
+    const double count{ static_cast<double>(m_Count) };
+    double fromMean[3]{}, toMean[3]{};
+    for (size_t axis{}; axis < 3; ++axis)
+    {
+        fromMean[axis] = m_From[axis] / count;
+        toMean[axis] = m_To[axis] / count;
+    }
+
+    //cross covariance around the centroids
+    double s[3][3]{};
+    for (size_t row{}; row < 3; ++row)
+    {
+        for (size_t column{}; column < 3; ++column) s[row][column] = m_Cross[row][column] - count * fromMean[row] * toMean[column];
+    }
+
+    //Horn's symmetric matrix, its top eigenvector is the rotation quaternion (w, x, y, z)
+    double horn[4][4]{
+        { s[0][0] + s[1][1] + s[2][2], s[1][2] - s[2][1], s[2][0] - s[0][2], s[0][1] - s[1][0] },
+        { s[1][2] - s[2][1], s[0][0] - s[1][1] - s[2][2], s[0][1] + s[1][0], s[2][0] + s[0][2] },
+        { s[2][0] - s[0][2], s[0][1] + s[1][0], -s[0][0] + s[1][1] - s[2][2], s[1][2] + s[2][1] },
+        { s[0][1] - s[1][0], s[2][0] + s[0][2], s[1][2] + s[2][1], -s[0][0] - s[1][1] + s[2][2] } };
+    double quaternion[4]{};
+    TopEigenvector(horn, quaternion);
+
+    //FlyFish stores the rotor bivector with the opposite sign of the quaternion vector part
+    const double length{ std::sqrt(quaternion[0] * quaternion[0] + quaternion[1] * quaternion[1]
+        + quaternion[2] * quaternion[2] + quaternion[3] * quaternion[3]) };
+    const Motor rotation{ static_cast<float>(quaternion[0] / length), 0, 0, 0,
+        static_cast<float>(-quaternion[1] / length), static_cast<float>(-quaternion[2] / length), static_cast<float>(-quaternion[3] / length), 0 };
+
+    //whatever the rotation leaves between the centroids is the translation
+    const ThreeBlade fromCenter{
+        static_cast<float>(m_FromReference[0] + fromMean[0]),
+        static_cast<float>(m_FromReference[1] + fromMean[1]),
+        static_cast<float>(m_FromReference[2] + fromMean[2]) };
+    const ThreeBlade rotatedCenter{ (rotation * fromCenter * ~rotation).Grade3() };
+    const float offset[3]{
+        static_cast<float>(m_ToReference[0] + toMean[0]) - rotatedCenter[0],
+        static_cast<float>(m_ToReference[1] + toMean[1]) - rotatedCenter[1],
+        static_cast<float>(m_ToReference[2] + toMean[2]) - rotatedCenter[2] };
+
+    //same translator Motor::Translation builds, without its division by the length of a zero offset
+    const Motor translation{ 1, -offset[0] / 2, -offset[1] / 2, -offset[2] / 2, 0, 0, 0, 0 };
+    return translation * rotation;
+}
+
+namespace estimation
+{
+    Motor FitMotor(const PointBatch& from, const PointBatch& to)
+    {
+        MotorFitter fitter{};
+        fitter.Add(from, to, 0, std::min(from.Size(), to.Size()));
+        return fitter.Solve();
+    }
+
+    void FitMotors(const PointBatch& from, const PointBatch& to, const std::vector<size_t>& offsets, std::vector<Motor>& out)
+    {
+        const size_t pairCount{ std::min(from.Size(), to.Size()) };
+        out.resize(offsets.empty() ? 0 : offsets.size() - 1);
+
+        MotorFitter fitter{};
+        for (size_t fit{}; fit < out.size(); ++fit)
+        {
+            const size_t first{ std::min(offsets[fit], pairCount) };
+            const size_t last{ std::min(std::max(offsets[fit + 1], first), pairCount) };
+            fitter.Clear();
+            fitter.Add(from, to, first, last - first);
+            out[fit] = fitter.Solve();
+        }
+    }
+}
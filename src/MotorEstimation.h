@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Streaming least-squares fit of the motor that maps a set of points onto their correspondences.
+// Every Add only updates running sums (centroids and the cross covariance), Solve turns them into
+// the motor minimizing the summed squared distance between (M * from * ~M).Grade3() and to.
+class MotorFitter
+{
+public:
+    void Add(const ThreeBlade& from, const ThreeBlade& to);
+    // Adds the pairs first .. first + count of two batches in one vectorized pass
+    void Add(const PointBatch& from, const PointBatch& to, size_t first, size_t count);
+    void Clear();
+
+    [[nodiscard]] size_t Count() const { return m_Count; }
+
+    // Identity when nothing was added. Fewer than three non collinear pairs leave the rotation
+    // about their common line undetermined, any of the equally good motors is returned then.
+    [[nodiscard]] Motor Solve() const;
+
+private:
+    //sums are taken relative to the first pair, which keeps the float sums small
+    float m_FromReference[3]{};
+    float m_ToReference[3]{};
+    size_t m_Count{};
+    double m_From[3]{};
+    double m_To[3]{};
+    double m_Cross[3][3]{};
+
+    void SetReference(float fromX, float fromY, float fromZ, float toX, float toY, float toZ);
+};
+
+namespace estimation
+{
+    // Best fit motor mapping from[i] onto to[i], the shorter batch decides the count
+    [[nodiscard]] Motor FitMotor(const PointBatch& from, const PointBatch& to);
+
+    // Many independent fits over packed batches: fit i uses the pairs offsets[i] .. offsets[i + 1],
+    // so offsets holds one entry more than there are fits. out is resized to the number of fits.
+    void FitMotors(const PointBatch& from, const PointBatch& to, const std::vector<size_t>& offsets, std::vector<Motor>& out);
+}
@@ -0,0 +1,57 @@
+#include "Orbit.h"
+
+#include <cmath>
+
+namespace
+{
+    constexpr float g_TwoPi{ 6.28318530718f };
+}
+
+Orbit::Orbit(const TwoBlade& axis, const ThreeBlade& point, float degreesPerSecond, float startTime)
+    : m_AngularSpeed{ degreesPerSecond * DEG_TO_RAD }
+{
+    //unit direction and the point of the axis closest to the origin, (e23, e31, e12) x (e01, e02, e03) / |direction|^2
+    const float length{ axis.Norm() };
+    const float direction[3]{ axis[3] / length, axis[4] / length, axis[5] / length };
+    const float closest[3]{
+        (direction[1] * axis[2] - direction[2] * axis[1]) / length,
+        (direction[2] * axis[0] - direction[0] * axis[2]) / length,
+        (direction[0] * axis[1] - direction[1] * axis[0]) / length };
+
+    const float position[3]{ point[0] / point[3], point[1] / point[3], point[2] / point[3] };
+    float along{};
+    for (size_t idx{}; idx < 3; ++idx) along += (position[idx] - closest[idx]) * direction[idx];
+    for (size_t idx{}; idx < 3; ++idx) m_Center[idx] = closest[idx] + along * direction[idx];
+
+    float offset[3]{};
+    for (size_t idx{}; idx < 3; ++idx) offset[idx] = position[idx] - m_Center[idx];
+    m_Radius = std::sqrt(offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]);
+    if (m_Radius > 0)
+    {
+        //Motor::Rotation turns the radius towards direction x radius
+        for (size_t idx{}; idx < 3; ++idx) m_Radial[idx] = offset[idx] / m_Radius;
+        m_Tangent[0] = direction[1] * m_Radial[2] - direction[2] * m_Radial[1];
+        m_Tangent[1] = direction[2] * m_Radial[0] - direction[0] * m_Radial[2];
+        m_Tangent[2] = direction[0] * m_Radial[1] - direction[1] * m_Radial[0];
+    }
+    m_Phase = std::fmod(-m_AngularSpeed * startTime, g_TwoPi);
+}
+
+ThreeBlade Orbit::At(float time) const
+{
+    const float angle{ m_Phase + m_AngularSpeed * time };
+    const float cosine{ m_Radius * std::cos(angle) };
+    const float sine{ m_Radius * std::sin(angle) };
+    return ThreeBlade{
+        m_Center[0] + cosine * m_Radial[0] + sine * m_Tangent[0],
+        m_Center[1] + cosine * m_Radial[1] + sine * m_Tangent[1],
+        m_Center[2] + cosine * m_Radial[2] + sine * m_Tangent[2] };
+}
+
+void Orbit::SetSpeed(float time, float degreesPerSecond)
+{
+    const float angularSpeed{ degreesPerSecond * DEG_TO_RAD };
+    //the angle at time is kept, wrapped so long sessions keep their precision
+    m_Phase = std::fmod(m_Phase + (m_AngularSpeed - angularSpeed) * time, g_TwoPi);
+    m_AngularSpeed = angularSpeed;
+}
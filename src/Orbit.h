@@ -0,0 +1,35 @@
+#pragma once
+
+#include "FlyFish.h"
+
+// A point circling an axis at constant speed, stored as center, radius, phase and angular speed.
+// The position at any time is evaluated in closed form, so nothing accumulates from frame to frame:
+// it costs one sine and one cosine, never drifts off the circle and can be asked for any time, past or future.
+class Orbit
+{
+public:
+    Orbit() = default;
+    // point circles axis, starting at startTime, turning the way Motor::Rotation turns around the axis direction.
+    // Unlike Motor::Rotation the axis does not have to pass through the origin.
+    Orbit(const TwoBlade& axis, const ThreeBlade& point, float degreesPerSecond, float startTime = 0);
+
+    [[nodiscard]] ThreeBlade At(float time) const;
+    // Changes the speed from time on, At(time) stays where it is
+    void SetSpeed(float time, float degreesPerSecond);
+
+    [[nodiscard]] const ThreeBlade& Center() const { return m_Center; }
+    [[nodiscard]] float Radius() const { return m_Radius; }
+    // Radians at time 0
+    [[nodiscard]] float Phase() const { return m_Phase; }
+    // Radians per second
+    [[nodiscard]] float AngularSpeed() const { return m_AngularSpeed; }
+
+private:
+    ThreeBlade m_Center{ 0, 0, 0 };
+    float m_Radius{};
+    float m_Phase{};
+    float m_AngularSpeed{};
+    // Unit vectors towards the point at angle 0 and a quarter turn further
+    float m_Radial[3]{ 1, 0, 0 };
+    float m_Tangent[3]{ 0, 1, 0 };
+};
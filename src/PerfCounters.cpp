@@ -0,0 +1,138 @@
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+	struct EventConfig
+	{
+		unsigned type;
+		unsigned long long config;
+	};
+
+	constexpr EventConfig g_Events[PerfCounters::EventCount]{
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES } };
+
+	int OpenEvent(const EventConfig& event)
+	{
+		perf_event_attr attributes{};
+		attributes.size = sizeof(attributes);
+		attributes.type = event.type;
+		attributes.config = event.config;
+		attributes.disabled = 1;
+		//user space only, which is all perf_event_paranoid 2 allows and all the benchmarks run in
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+	}
+
+	//value, time enabled, time running
+	bool ReadEvent(int file, unsigned long long* values)
+	{
+		return file >= 0 && read(file, values, 3 * sizeof(unsigned long long)) == static_cast<ssize_t>(3 * sizeof(unsigned long long));
+	}
+}
+
+PerfCounters::PerfCounters()
+{
+	int error{};
+	for (int event{}; event < EventCount; ++event)
+	{
+		m_Files[event] = OpenEvent(g_Events[event]);
+		if (m_Files[event] < 0) error = errno;
+	}
+	if (!Available()) m_Error = std::string{ "perf_event_open failed: " } + std::strerror(error);
+}
+
+PerfCounters::~PerfCounters()
+{
+	for (const int file : m_Files)
+	{
+		if (file >= 0) close(file);
+	}
+}
+
+void PerfCounters::Reset()
+{
+	for (int event{}; event < EventCount; ++event)
+	{
+		if (m_Files[event] < 0) continue;
+		ioctl(m_Files[event], PERF_EVENT_IOC_RESET, 0);
+
+		//the times keep running from when the event was opened
+		unsigned long long values[3]{};
+		if (!ReadEvent(m_Files[event], values)) continue;
+		m_ResetTimes[event][0] = values[1];
+		m_ResetTimes[event][1] = values[2];
+	}
+}
+
+void PerfCounters::Start()
+{
+	for (const int file : m_Files)
+	{
+		if (file >= 0) ioctl(file, PERF_EVENT_IOC_ENABLE, 0);
+	}
+}
+
+void PerfCounters::Stop()
+{
+	for (const int file : m_Files)
+	{
+		if (file >= 0) ioctl(file, PERF_EVENT_IOC_DISABLE, 0);
+	}
+}
+
+double PerfCounters::Count(Event event) const
+{
+	unsigned long long values[3]{};
+	if (!ReadEvent(m_Files[event], values)) return std::numeric_limits<double>::quiet_NaN();
+
+	//NaN when the event never got a hardware counter since the last Reset
+	const unsigned long long enabled{ values[1] - m_ResetTimes[event][0] };
+	const unsigned long long running{ values[2] - m_ResetTimes[event][1] };
+	if (running == 0) return std::numeric_limits<double>::quiet_NaN();
+	return static_cast<double>(values[0]) * static_cast<double>(enabled) / static_cast<double>(running);
+}
+
+#else
+
+PerfCounters::PerfCounters()
+	: m_Error{ "hardware counters are only read on Linux" }
+{
+	for (int& file : m_Files) file = -1;
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::Reset() {}
+void PerfCounters::Start() {}
+void PerfCounters::Stop() {}
+
+double PerfCounters::Count(Event) const
+{
+	return std::numeric_limits<double>::quiet_NaN();
+}
+
+#endif
+
+bool PerfCounters::Available() const
+{
+	for (const int file : m_Files)
+	{
+		if (file >= 0) return true;
+	}
+	return false;
+}
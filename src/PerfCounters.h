@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+
+// Hardware event counts over stretches of code, read from Linux perf_event.
+// Every event is opened on its own so one the CPU or the hypervisor lacks does not take the others with it.
+// Where nothing can be opened (other systems, containers without perf access, perf_event_paranoid) the
+// counters stay unavailable and Count returns NaN, the timings themselves are not affected.
+class PerfCounters
+{
+public:
+	enum Event
+	{
+		Cycles,
+		Instructions,
+		L1Misses,
+		LLCMisses,
+		BranchMisses,
+		EventCount
+	};
+
+	PerfCounters();
+	~PerfCounters();
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	[[nodiscard]] bool Available() const;
+	[[nodiscard]] bool Available(Event event) const { return m_Files[event] >= 0; }
+	// Why no event could be opened, empty when at least one works
+	[[nodiscard]] const std::string& Error() const { return m_Error; }
+
+	// Counting is cumulative over every Start / Stop pair since the last Reset
+	void Reset();
+	void Start();
+	void Stop();
+
+	// Events counted so far, scaled up when the kernel had to share the hardware counters. NaN when unavailable.
+	[[nodiscard]] double Count(Event event) const;
+
+private:
+	int m_Files[EventCount];
+	// time enabled and time running at the last Reset, which only zeroes the count, so Count scales by the times since
+	unsigned long long m_ResetTimes[EventCount][2]{};
+	std::string m_Error{};
+};
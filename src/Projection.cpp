@@ -0,0 +1,239 @@
+#include "Projection.h"
+
+namespace
+{
+    struct PlaneTarget
+    {
+        explicit PlaneTarget(const OneBlade& plane)
+            : d{ plane[0] }, nx{ plane[1] }, ny{ plane[2] }, nz{ plane[3] }
+        {
+            const float normSquared{ nx * nx + ny * ny + nz * nz };
+            kx = nx / normSquared;
+            ky = ny / normSquared;
+            kz = nz / normSquared;
+        }
+        //k = n / |n|^2, so moving a point by (plane & point) * k lands it on the plane
+        float d, nx, ny, nz, kx{}, ky{}, kz{};
+    };
+
+    struct LineTarget
+    {
+        explicit LineTarget(const TwoBlade& line)
+            : dx{ line[3] }, dy{ line[4] }, dz{ line[5] }
+        {
+            const float normSquared{ dx * dx + dy * dy + dz * dz };
+            //the moment is q x d for any q on the line, so d x m / |d|^2 is the point closest to the origin
+            fx = (dy * line[2] - dz * line[1]) / normSquared;
+            fy = (dz * line[0] - dx * line[2]) / normSquared;
+            fz = (dx * line[1] - dy * line[0]) / normSquared;
+            kx = dx / normSquared;
+            ky = dy / normSquared;
+            kz = dz / normSquared;
+        }
+        float dx, dy, dz, fx{}, fy{}, fz{}, kx{}, ky{}, kz{};
+    };
+
+    // Kernels take and write the components in FlyFish order, the scalar and batch versions share them
+
+    void PointPlaneOffset(const PlaneTarget& plane, const float* point, float* offset)
+    {
+        const float distance{ plane.nx * point[0] + plane.ny * point[1] + plane.nz * point[2] + plane.d * point[3] };
+        offset[0] = distance * plane.kx;
+        offset[1] = distance * plane.ky;
+        offset[2] = distance * plane.kz;
+        offset[3] = 0;
+    }
+
+    void PointLineFoot(const LineTarget& line, const float* point, float* foot)
+    {
+        const float along{ line.dx * point[0] + line.dy * point[1] + line.dz * point[2] };
+        foot[0] = point[3] * line.fx + along * line.kx;
+        foot[1] = point[3] * line.fy + along * line.ky;
+        foot[2] = point[3] * line.fz + along * line.kz;
+        foot[3] = point[3];
+    }
+
+    void ProjectPointPlane(const PlaneTarget& plane, const float* point, float* out)
+    {
+        PointPlaneOffset(plane, point, out);
+        for (size_t component{}; component < 3; ++component) out[component] = point[component] - out[component];
+        out[3] = point[3];
+    }
+
+    void RejectPointPlane(const PlaneTarget& plane, const float* point, float* out)
+    {
+        PointPlaneOffset(plane, point, out);
+    }
+
+    void ProjectPointLine(const LineTarget& line, const float* point, float* out)
+    {
+        PointLineFoot(line, point, out);
+    }
+
+    void RejectPointLine(const LineTarget& line, const float* point, float* out)
+    {
+        PointLineFoot(line, point, out);
+        for (size_t component{}; component < 3; ++component) out[component] = point[component] - out[component];
+        out[3] = 0;
+    }
+
+    void ProjectLinePlane(const PlaneTarget& plane, const float* line, float* out)
+    {
+        //d' = d - (d . n) k and m' = m - (n x m) x k - plane.d * (k x d), which is q' x d' for q' the projection
+        //of a point q on the line, expanded so it needs no point on the line
+        const float mx{ line[0] }, my{ line[1] }, mz{ line[2] };
+        const float dx{ line[3] }, dy{ line[4] }, dz{ line[5] };
+        const float cx{ plane.ny * mz - plane.nz * my };
+        const float cy{ plane.nz * mx - plane.nx * mz };
+        const float cz{ plane.nx * my - plane.ny * mx };
+        out[0] = mx - (cy * plane.kz - cz * plane.ky) - plane.d * (plane.ky * dz - plane.kz * dy);
+        out[1] = my - (cz * plane.kx - cx * plane.kz) - plane.d * (plane.kz * dx - plane.kx * dz);
+        out[2] = mz - (cx * plane.ky - cy * plane.kx) - plane.d * (plane.kx * dy - plane.ky * dx);
+
+        const float along{ dx * plane.nx + dy * plane.ny + dz * plane.nz };
+        out[3] = dx - along * plane.kx;
+        out[4] = dy - along * plane.ky;
+        out[5] = dz - along * plane.kz;
+    }
+
+    void RejectLinePlane(const PlaneTarget& plane, const float* line, float* out)
+    {
+        //line ^ plane, then the line through that point along the normal: moment x x n, direction w n
+        const float x{ -line[3] * plane.d + line[2] * plane.ny - line[1] * plane.nz };
+        const float y{ -line[4] * plane.d - line[2] * plane.nx + line[0] * plane.nz };
+        const float z{ -line[5] * plane.d + line[1] * plane.nx - line[0] * plane.ny };
+        const float w{ line[3] * plane.nx + line[4] * plane.ny + line[5] * plane.nz };
+        out[0] = y * plane.nz - z * plane.ny;
+        out[1] = z * plane.nx - x * plane.nz;
+        out[2] = x * plane.ny - y * plane.nx;
+        out[3] = w * plane.nx;
+        out[4] = w * plane.ny;
+        out[5] = w * plane.nz;
+    }
+
+    void ProjectPlanePoint(const ThreeBlade& point, const float* plane, float* out)
+    {
+        out[0] = -(plane[1] * point[0] + plane[2] * point[1] + plane[3] * point[2]);
+        for (size_t component{ 1 }; component < 4; ++component) out[component] = point[3] * plane[component];
+    }
+
+    void RejectPlanePoint(const ThreeBlade& point, const float* plane, float* out)
+    {
+        out[0] = plane[1] * point[0] + plane[2] * point[1] + plane[3] * point[2] + plane[0] * point[3];
+        for (size_t component{ 1 }; component < 4; ++component) out[component] = 0;
+    }
+
+    template <typename Result, typename Element, typename Target>
+    Result Apply(const Element& element, const Target& target, void (*kernel)(const Target&, const float*, float*))
+    {
+        Result result{};
+        kernel(target, &element[0], &result[0]);
+        return result;
+    }
+
+    template <typename InBatch, typename OutBatch, typename Target>
+    void ApplyBatch(const InBatch& in, const Target& target, OutBatch& out, void (*kernel)(const Target&, const float*, float*))
+    {
+        const size_t count{ in.Size() };
+        out.Resize(count);
+
+        const float* source[InBatch::Components]{};
+        for (size_t component{}; component < InBatch::Components; ++component) source[component] = in.Component(component);
+        float* destination[OutBatch::Components]{};
+        for (size_t component{}; component < OutBatch::Components; ++component) destination[component] = out.Component(component);
+
+        //the kernel inlines into the loop, its element arrays become registers
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            float element[InBatch::Components]{};
+            for (size_t component{}; component < InBatch::Components; ++component) element[component] = source[component][idx];
+            float result[OutBatch::Components]{};
+            kernel(target, element, result);
+            for (size_t component{}; component < OutBatch::Components; ++component) destination[component][idx] = result[component];
+        }
+    }
+}
+
+namespace projection
+{
+    ThreeBlade Project(const ThreeBlade& point, const OneBlade& plane)
+    {
+        return Apply<ThreeBlade>(point, PlaneTarget{ plane }, ProjectPointPlane);
+    }
+
+    ThreeBlade Project(const ThreeBlade& point, const TwoBlade& line)
+    {
+        return Apply<ThreeBlade>(point, LineTarget{ line }, ProjectPointLine);
+    }
+
+    TwoBlade Project(const TwoBlade& line, const OneBlade& plane)
+    {
+        return Apply<TwoBlade>(line, PlaneTarget{ plane }, ProjectLinePlane);
+    }
+
+    OneBlade Project(const OneBlade& plane, const ThreeBlade& point)
+    {
+        return Apply<OneBlade>(plane, point, ProjectPlanePoint);
+    }
+
+    ThreeBlade Reject(const ThreeBlade& point, const OneBlade& plane)
+    {
+        return Apply<ThreeBlade>(point, PlaneTarget{ plane }, RejectPointPlane);
+    }
+
+    ThreeBlade Reject(const ThreeBlade& point, const TwoBlade& line)
+    {
+        return Apply<ThreeBlade>(point, LineTarget{ line }, RejectPointLine);
+    }
+
+    TwoBlade Reject(const TwoBlade& line, const OneBlade& plane)
+    {
+        return Apply<TwoBlade>(line, PlaneTarget{ plane }, RejectLinePlane);
+    }
+
+    OneBlade Reject(const OneBlade& plane, const ThreeBlade& point)
+    {
+        return Apply<OneBlade>(plane, point, RejectPlanePoint);
+    }
+
+    void Project(const PointBatch& points, const OneBlade& plane, PointBatch& out)
+    {
+        ApplyBatch(points, PlaneTarget{ plane }, out, ProjectPointPlane);
+    }
+
+    void Project(const PointBatch& points, const TwoBlade& line, PointBatch& out)
+    {
+        ApplyBatch(points, LineTarget{ line }, out, ProjectPointLine);
+    }
+
+    void Project(const LineBatch& lines, const OneBlade& plane, LineBatch& out)
+    {
+        ApplyBatch(lines, PlaneTarget{ plane }, out, ProjectLinePlane);
+    }
+
+    void Project(const PlaneBatch& planes, const ThreeBlade& point, PlaneBatch& out)
+    {
+        ApplyBatch(planes, point, out, ProjectPlanePoint);
+    }
+
+    void Reject(const PointBatch& points, const OneBlade& plane, PointBatch& out)
+    {
+        ApplyBatch(points, PlaneTarget{ plane }, out, RejectPointPlane);
+    }
+
+    void Reject(const PointBatch& points, const TwoBlade& line, PointBatch& out)
+    {
+        ApplyBatch(points, LineTarget{ line }, out, RejectPointLine);
+    }
+
+    void Reject(const LineBatch& lines, const OneBlade& plane, LineBatch& out)
+    {
+        ApplyBatch(lines, PlaneTarget{ plane }, out, RejectLinePlane);
+    }
+
+    void Reject(const PlaneBatch& planes, const ThreeBlade& point, PlaneBatch& out)
+    {
+        ApplyBatch(planes, point, out, RejectPlanePoint);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Orthogonal projection and rejection per blade pair, written out in closed form instead of (a | b) * ~b,
+// which goes through a full MultiVector product. Results keep the weight of the element being projected,
+// so they match the GA formula up to scale and ideal elements stay ideal.
+namespace projection
+{
+    // The foot of the perpendicular from point to plane
+    [[nodiscard]] ThreeBlade Project(const ThreeBlade& point, const OneBlade& plane);
+    // The closest point on line
+    [[nodiscard]] ThreeBlade Project(const ThreeBlade& point, const TwoBlade& line);
+    // The shadow of line on plane along the plane normal, zero when line is perpendicular to plane
+    [[nodiscard]] TwoBlade Project(const TwoBlade& line, const OneBlade& plane);
+    // The plane through point parallel to plane
+    [[nodiscard]] OneBlade Project(const OneBlade& plane, const ThreeBlade& point);
+
+    // point - Project(point, plane): the ideal point along the normal from the foot to point
+    [[nodiscard]] ThreeBlade Reject(const ThreeBlade& point, const OneBlade& plane);
+    // point - Project(point, line): the ideal point from the closest point on line to point
+    [[nodiscard]] ThreeBlade Reject(const ThreeBlade& point, const TwoBlade& line);
+    // The normal of plane through the point where line meets it, at infinity when line is parallel to plane
+    [[nodiscard]] TwoBlade Reject(const TwoBlade& line, const OneBlade& plane);
+    // weight * plane - Project(plane, point): the plane at infinity, scaled by plane & point
+    [[nodiscard]] OneBlade Reject(const OneBlade& plane, const ThreeBlade& point);
+
+    // Batch variants: every element against the same target in one pass, out is resized to the input
+    void Project(const PointBatch& points, const OneBlade& plane, PointBatch& out);
+    void Project(const PointBatch& points, const TwoBlade& line, PointBatch& out);
+    void Project(const LineBatch& lines, const OneBlade& plane, LineBatch& out);
+    void Project(const PlaneBatch& planes, const ThreeBlade& point, PlaneBatch& out);
+
+    void Reject(const PointBatch& points, const OneBlade& plane, PointBatch& out);
+    void Reject(const PointBatch& points, const TwoBlade& line, PointBatch& out);
+    void Reject(const LineBatch& lines, const OneBlade& plane, LineBatch& out);
+    void Reject(const PlaneBatch& planes, const ThreeBlade& point, PlaneBatch& out);
+}
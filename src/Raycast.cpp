@@ -0,0 +1,361 @@
+#include "Raycast.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr float g_NoHit{ std::numeric_limits<float>::infinity() };
+
+    // The batched and single ray paths share these, so both agree on t bit for bit
+
+    // Where the ray meets plane & point = 0, scale of the plane does not matter
+    inline float PlaneT(float ox, float oy, float oz, float dx, float dy, float dz,
+        float e0, float e1, float e2, float e3)
+    {
+        return -(e1 * ox + e2 * oy + e3 * oz + e0) / (e1 * dx + e2 * dy + e3 * dz);
+    }
+
+    inline float SphereT(float ox, float oy, float oz, float dx, float dy, float dz,
+        float cx, float cy, float cz, float radius)
+    {
+        const float mx{ cx - ox }, my{ cy - oy }, mz{ cz - oz };
+        //closest approach of the line to the center, then back up half a chord
+        const float tc{ mx * dx + my * dy + mz * dz };
+        const float discriminant{ radius * radius - (mx * mx + my * my + mz * mz - tc * tc) };
+        //a miss leaves a negative discriminant and the NaN fails every t comparison, no branch needed
+        const float halfChord{ std::sqrt(discriminant) };
+        return tc + (tc >= halfChord ? -halfChord : halfChord);
+    }
+
+    // Where the ray enters and leaves the space between two opposite face planes of a box.
+    // A ray parallel to the planes is between them for every t or for none; (lo - o) * inv would be 0 * inf = NaN
+    // with the origin on a face plane, so that case is tested on the origin instead
+    inline void SlabT(float o, float inv, float lo, float hi, float& tNear, float& tFar)
+    {
+        const float t1{ (lo - o) * inv }, t2{ (hi - o) * inv };
+        const bool parallel{ std::fabs(inv) == g_NoHit };
+        const float outside{ lo <= o && o <= hi ? -g_NoHit : g_NoHit };
+        tNear = parallel ? outside : std::min(t1, t2);
+        tFar = parallel ? -outside : std::max(t1, t2);
+    }
+
+    // Slab test, each slab is the space between two opposite face planes of the box
+    inline float BoxT(float ox, float oy, float oz, float invDx, float invDy, float invDz,
+        float minX, float minY, float minZ, float maxX, float maxY, float maxZ)
+    {
+        float xNear{}, xFar{}, yNear{}, yFar{}, zNear{}, zFar{};
+        SlabT(ox, invDx, minX, maxX, xNear, xFar);
+        SlabT(oy, invDy, minY, maxY, yNear, yFar);
+        SlabT(oz, invDz, minZ, maxZ, zNear, zFar);
+        const float tNear{ std::max(std::max(xNear, yNear), zNear) };
+        const float tFar{ std::min(std::min(xFar, yFar), zFar) };
+        const float t{ tNear >= 0 ? tNear : tFar };
+        return tNear <= tFar ? t : g_NoHit;
+    }
+
+    // Tangent plane through point with unit normal n, flipped to face against the ray direction
+    OneBlade FacingPlane(const ThreeBlade& point, float nx, float ny, float nz, const TwoBlade& line)
+    {
+        if (nx * line[3] + ny * line[4] + nz * line[5] > 0)
+        {
+            nx = -nx;
+            ny = -ny;
+            nz = -nz;
+        }
+        return OneBlade{ -(nx * point[0] + ny * point[1] + nz * point[2]), nx, ny, nz };
+    }
+
+    RayHit MakeHit(const Ray& ray, PrimitiveType type, float t)
+    {
+        RayHit hit{};
+        hit.type = type;
+        hit.t = t;
+        hit.point = ray.At(t);
+        return hit;
+    }
+
+    bool IsCloser(float t, float maxDistance)
+    {
+        return t >= 0 && t < maxDistance;
+    }
+}
+
+Ray::Ray(const ThreeBlade& start, const TwoBlade& direction)
+    : origin{ start.Normalized() }
+    , line{ direction.Normalized() }
+{
+}
+
+Ray Ray::Through(const ThreeBlade& origin, const ThreeBlade& target)
+{
+    return Ray{ origin, origin & target };
+}
+
+ThreeBlade Ray::At(float t) const
+{
+    return ThreeBlade{ origin[0] + t * line[3], origin[1] + t * line[4], origin[2] + t * line[5] };
+}
+
+int RayScene::Add(const OneBlade& plane)
+{
+    m_Planes.PushBack(plane);
+    return static_cast<int>(m_Planes.Size()) - 1;
+}
+
+int RayScene::Add(const Sphere& sphere)
+{
+    m_SphereCenters.PushBack(sphere.center.Normalized());
+    m_SphereRadii.push_back(sphere.radius);
+    return static_cast<int>(m_SphereCenters.Size()) - 1;
+}
+
+int RayScene::Add(const Box& box)
+{
+    const ThreeBlade a{ box.min.Normalized() };
+    const ThreeBlade b{ box.max.Normalized() };
+    m_BoxMins.PushBack(ThreeBlade{ std::min(a[0], b[0]), std::min(a[1], b[1]), std::min(a[2], b[2]) });
+    m_BoxMaxs.PushBack(ThreeBlade{ std::max(a[0], b[0]), std::max(a[1], b[1]), std::max(a[2], b[2]) });
+    return static_cast<int>(m_BoxMins.Size()) - 1;
+}
+
+void RayScene::Clear()
+{
+    m_Planes.Clear();
+    m_SphereCenters.Clear();
+    m_SphereRadii.clear();
+    m_BoxMins.Clear();
+    m_BoxMaxs.Clear();
+}
+
+RayBatch::RayBatch(const std::vector<Ray>& rays)
+{
+    Reserve(rays.size());
+    for (const Ray& ray : rays)
+    {
+        PushBack(ray);
+    }
+}
+
+void RayBatch::Reserve(size_t capacity)
+{
+    m_Origins.Reserve(capacity);
+    m_Lines.Reserve(capacity);
+}
+
+void RayBatch::Clear()
+{
+    m_Origins.Clear();
+    m_Lines.Clear();
+}
+
+void RayBatch::PushBack(const Ray& ray)
+{
+    m_Origins.PushBack(ray.origin);
+    m_Lines.PushBack(ray.line);
+}
+
+namespace raycast
+{
+    RayHit Intersect(const Ray& ray, const OneBlade& plane, float maxDistance)
+    {
+        const ThreeBlade& o{ ray.origin };
+        const TwoBlade& l{ ray.line };
+        const float t{ PlaneT(o[0], o[1], o[2], l[3], l[4], l[5], plane[0], plane[1], plane[2], plane[3]) };
+        if (!IsCloser(t, maxDistance)) return RayHit{};
+
+        RayHit hit{ MakeHit(ray, PrimitiveType::Plane, t) };
+        const OneBlade unit{ plane.Normalized() };
+        hit.normal = FacingPlane(hit.point, unit[1], unit[2], unit[3], l);
+        return hit;
+    }
+
+    RayHit Intersect(const Ray& ray, const Sphere& sphere, float maxDistance)
+    {
+        const ThreeBlade& o{ ray.origin };
+        const TwoBlade& l{ ray.line };
+        const ThreeBlade c{ sphere.center.Normalized() };
+        const float t{ SphereT(o[0], o[1], o[2], l[3], l[4], l[5], c[0], c[1], c[2], sphere.radius) };
+        if (!IsCloser(t, maxDistance)) return RayHit{};
+
+        RayHit hit{ MakeHit(ray, PrimitiveType::Sphere, t) };
+        const float invRadius{ 1 / sphere.radius };
+        hit.normal = FacingPlane(hit.point,
+            (hit.point[0] - c[0]) * invRadius, (hit.point[1] - c[1]) * invRadius, (hit.point[2] - c[2]) * invRadius, l);
+        return hit;
+    }
+
+    RayHit Intersect(const Ray& ray, const Box& box, float maxDistance)
+    {
+        const ThreeBlade& o{ ray.origin };
+        const TwoBlade& l{ ray.line };
+        const ThreeBlade a{ box.min.Normalized() };
+        const ThreeBlade b{ box.max.Normalized() };
+        const float lo[3]{ std::min(a[0], b[0]), std::min(a[1], b[1]), std::min(a[2], b[2]) };
+        const float hi[3]{ std::max(a[0], b[0]), std::max(a[1], b[1]), std::max(a[2], b[2]) };
+        const float inv[3]{ 1 / l[3], 1 / l[4], 1 / l[5] };
+        const float t{ BoxT(o[0], o[1], o[2], inv[0], inv[1], inv[2], lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]) };
+        if (!IsCloser(t, maxDistance)) return RayHit{};
+
+        //the face hit is the slab entered last, or the one left first when starting inside
+        float nearT[3]{}, farT[3]{};
+        for (size_t idx{}; idx < 3; ++idx) SlabT(o[idx], inv[idx], lo[idx], hi[idx], nearT[idx], farT[idx]);
+        const bool inside{ std::max({ nearT[0], nearT[1], nearT[2] }) < 0 };
+        const size_t axis{ inside
+            ? static_cast<size_t>(std::min_element(farT, farT + 3) - farT)
+            : static_cast<size_t>(std::max_element(nearT, nearT + 3) - nearT) };
+
+        RayHit hit{ MakeHit(ray, PrimitiveType::Box, t) };
+        float n[3]{};
+        n[axis] = 1;
+        hit.normal = FacingPlane(hit.point, n[0], n[1], n[2], l);
+        return hit;
+    }
+
+    RayHit Cast(const Ray& ray, const RayScene& scene, float maxDistance)
+    {
+        RayHit nearest{};
+        nearest.t = maxDistance;
+
+        //same order and strict comparison as the batched cast, so ties resolve the same way
+        for (size_t idx{}; idx < scene.PlaneCount(); ++idx)
+        {
+            const RayHit hit{ Intersect(ray, scene.GetPlane(idx), nearest.t) };
+            if (hit.Hit())
+            {
+                nearest = hit;
+                nearest.index = static_cast<int>(idx);
+            }
+        }
+        for (size_t idx{}; idx < scene.SphereCount(); ++idx)
+        {
+            const RayHit hit{ Intersect(ray, scene.GetSphere(idx), nearest.t) };
+            if (hit.Hit())
+            {
+                nearest = hit;
+                nearest.index = static_cast<int>(idx);
+            }
+        }
+        for (size_t idx{}; idx < scene.BoxCount(); ++idx)
+        {
+            const RayHit hit{ Intersect(ray, scene.GetBox(idx), nearest.t) };
+            if (hit.Hit())
+            {
+                nearest = hit;
+                nearest.index = static_cast<int>(idx);
+            }
+        }
+
+        if (!nearest.Hit()) return RayHit{};
+        return nearest;
+    }
+
+    void Cast(const RayBatch& rays, const RayScene& scene, std::vector<RayHit>& hits, float maxDistance)
+    {
+        const size_t count{ rays.Size() };
+        const float* ox{ rays.Origins().Component(0) };
+        const float* oy{ rays.Origins().Component(1) };
+        const float* oz{ rays.Origins().Component(2) };
+        const float* dx{ rays.Lines().Component(3) };
+        const float* dy{ rays.Lines().Component(4) };
+        const float* dz{ rays.Lines().Component(5) };
+
+        //nearest t and primitive per ray, primitives are numbered planes first, then spheres, then boxes
+        std::vector<float> nearest(count, maxDistance);
+        std::vector<int> primitive(count, -1);
+        float* tOut{ nearest.data() };
+        int* idOut{ primitive.data() };
+        int id{};
+
+        const PlaneBatch& planes{ scene.Planes() };
+        for (size_t plane{}; plane < planes.Size(); ++plane, ++id)
+        {
+            const float e0{ planes.Component(0)[plane] }, e1{ planes.Component(1)[plane] };
+            const float e2{ planes.Component(2)[plane] }, e3{ planes.Component(3)[plane] };
+            FLYFISH_VECTORIZE
+            for (size_t ray{}; ray < count; ++ray)
+            {
+                const float t{ PlaneT(ox[ray], oy[ray], oz[ray], dx[ray], dy[ray], dz[ray], e0, e1, e2, e3) };
+                const float current{ tOut[ray] };
+                const bool closer{ t >= 0 && t < current };
+                tOut[ray] = closer ? t : current;
+                idOut[ray] = closer ? id : idOut[ray];
+            }
+        }
+
+        const PointBatch& centers{ scene.SphereCenters() };
+        for (size_t sphere{}; sphere < centers.Size(); ++sphere, ++id)
+        {
+            const float cx{ centers.Component(0)[sphere] }, cy{ centers.Component(1)[sphere] };
+            const float cz{ centers.Component(2)[sphere] }, radius{ scene.SphereRadii()[sphere] };
+            FLYFISH_VECTORIZE
+            for (size_t ray{}; ray < count; ++ray)
+            {
+                const float t{ SphereT(ox[ray], oy[ray], oz[ray], dx[ray], dy[ray], dz[ray], cx, cy, cz, radius) };
+                const float current{ tOut[ray] };
+                const bool closer{ t >= 0 && t < current };
+                tOut[ray] = closer ? t : current;
+                idOut[ray] = closer ? id : idOut[ray];
+            }
+        }
+
+        if (scene.BoxCount() > 0)
+        {
+            std::vector<float> inverse(count * 3);
+            float* invX{ inverse.data() };
+            float* invY{ invX + count };
+            float* invZ{ invY + count };
+            FLYFISH_VECTORIZE
+            for (size_t ray{}; ray < count; ++ray)
+            {
+                invX[ray] = 1 / dx[ray];
+                invY[ray] = 1 / dy[ray];
+                invZ[ray] = 1 / dz[ray];
+            }
+
+            const PointBatch& mins{ scene.BoxMins() };
+            const PointBatch& maxs{ scene.BoxMaxs() };
+            for (size_t box{}; box < mins.Size(); ++box, ++id)
+            {
+                const float minX{ mins.Component(0)[box] }, minY{ mins.Component(1)[box] }, minZ{ mins.Component(2)[box] };
+                const float maxX{ maxs.Component(0)[box] }, maxY{ maxs.Component(1)[box] }, maxZ{ maxs.Component(2)[box] };
+                FLYFISH_VECTORIZE
+                for (size_t ray{}; ray < count; ++ray)
+                {
+                    const float t{ BoxT(ox[ray], oy[ray], oz[ray], invX[ray], invY[ray], invZ[ray],
+                        minX, minY, minZ, maxX, maxY, maxZ) };
+                    const float current{ tOut[ray] };
+                    const bool closer{ t >= 0 && t < current };
+                    tOut[ray] = closer ? t : current;
+                    idOut[ray] = closer ? id : idOut[ray];
+                }
+            }
+        }
+
+        //only the winners need a hit point and normal, that part stays scalar
+        const int planeCount{ static_cast<int>(scene.PlaneCount()) };
+        const int sphereCount{ static_cast<int>(scene.SphereCount()) };
+        hits.assign(count, RayHit{});
+        for (size_t ray{}; ray < count; ++ray)
+        {
+            int index{ primitive[ray] };
+            if (index < 0) continue;
+
+            const Ray current{ rays.Get(ray) };
+            if (index < planeCount)
+            {
+                hits[ray] = Intersect(current, scene.GetPlane(index));
+            }
+            else if ((index -= planeCount) < sphereCount)
+            {
+                hits[ray] = Intersect(current, scene.GetSphere(index));
+            }
+            else
+            {
+                index -= sphereCount;
+                hits[ray] = Intersect(current, scene.GetBox(index));
+            }
+            hits[ray].index = index;
+        }
+    }
+}
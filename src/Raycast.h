@@ -0,0 +1,127 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// A ray is the half of a FlyFish line that starts at origin and runs along the line direction (e23, e31, e12).
+// Both are kept normalized, so the ray parameter t is the euclidean distance from the origin.
+struct Ray
+{
+    Ray() = default;
+    Ray(const ThreeBlade& start, const TwoBlade& direction);
+
+    // The ray from origin through target (origin & target)
+    [[nodiscard]] static Ray Through(const ThreeBlade& origin, const ThreeBlade& target);
+
+    [[nodiscard]] ThreeBlade At(float t) const;
+
+    ThreeBlade origin{ 0, 0, 0 };
+    TwoBlade line{ 0, 0, 0, 1, 0, 0 };
+};
+
+// In the z = 0 plane of the game a sphere doubles as a disc
+struct Sphere
+{
+    ThreeBlade center;
+    float radius;
+};
+
+// Axis aligned box between two corner points
+struct Box
+{
+    ThreeBlade min;
+    ThreeBlade max;
+};
+
+enum class PrimitiveType
+{
+    None,
+    Plane,
+    Sphere,
+    Box
+};
+
+struct RayHit
+{
+    [[nodiscard]] bool Hit() const { return type != PrimitiveType::None; }
+
+    PrimitiveType type{ PrimitiveType::None };
+    // Index of the primitive within its type, -1 for a miss
+    int index{ -1 };
+    float t{ std::numeric_limits<float>::infinity() };
+    ThreeBlade point{};
+    // Tangent plane at the hit, its normal facing the side the ray came from
+    OneBlade normal{};
+};
+
+// Primitives packed per type in structure-of-arrays form so batched casts stream through them
+class RayScene
+{
+public:
+    int Add(const OneBlade& plane);
+    int Add(const Sphere& sphere);
+    int Add(const Box& box);
+    void Clear();
+
+    [[nodiscard]] size_t PlaneCount() const { return m_Planes.Size(); }
+    [[nodiscard]] size_t SphereCount() const { return m_SphereCenters.Size(); }
+    [[nodiscard]] size_t BoxCount() const { return m_BoxMins.Size(); }
+    [[nodiscard]] size_t Size() const { return PlaneCount() + SphereCount() + BoxCount(); }
+
+    [[nodiscard]] OneBlade GetPlane(size_t idx) const { return m_Planes.Get(idx); }
+    [[nodiscard]] Sphere GetSphere(size_t idx) const { return Sphere{ m_SphereCenters.Get(idx), m_SphereRadii[idx] }; }
+    [[nodiscard]] Box GetBox(size_t idx) const { return Box{ m_BoxMins.Get(idx), m_BoxMaxs.Get(idx) }; }
+
+    [[nodiscard]] const PlaneBatch& Planes() const { return m_Planes; }
+    [[nodiscard]] const PointBatch& SphereCenters() const { return m_SphereCenters; }
+    [[nodiscard]] const std::vector<float>& SphereRadii() const { return m_SphereRadii; }
+    [[nodiscard]] const PointBatch& BoxMins() const { return m_BoxMins; }
+    [[nodiscard]] const PointBatch& BoxMaxs() const { return m_BoxMaxs; }
+
+private:
+    PlaneBatch m_Planes{};
+    PointBatch m_SphereCenters{};
+    std::vector<float> m_SphereRadii{};
+    PointBatch m_BoxMins{};
+    PointBatch m_BoxMaxs{};
+};
+
+// Rays in structure-of-arrays form, origins and lines stored normalized
+class RayBatch
+{
+public:
+    RayBatch() = default;
+    RayBatch(const std::vector<Ray>& rays);
+
+    [[nodiscard]] size_t Size() const { return m_Origins.Size(); }
+
+    void Reserve(size_t capacity);
+    void Clear();
+    void PushBack(const Ray& ray);
+    [[nodiscard]] Ray Get(size_t idx) const { return Ray{ m_Origins.Get(idx), m_Lines.Get(idx) }; }
+
+    [[nodiscard]] const PointBatch& Origins() const { return m_Origins; }
+    [[nodiscard]] const LineBatch& Lines() const { return m_Lines; }
+
+private:
+    PointBatch m_Origins{};
+    LineBatch m_Lines{};
+};
+
+namespace raycast
+{
+    // Single primitive tests, hits closer than maxDistance only. A ray starting inside a sphere or box hits its far side.
+    [[nodiscard]] RayHit Intersect(const Ray& ray, const OneBlade& plane, float maxDistance = std::numeric_limits<float>::infinity());
+    [[nodiscard]] RayHit Intersect(const Ray& ray, const Sphere& sphere, float maxDistance = std::numeric_limits<float>::infinity());
+    [[nodiscard]] RayHit Intersect(const Ray& ray, const Box& box, float maxDistance = std::numeric_limits<float>::infinity());
+
+    // Nearest hit over every primitive of the scene
+    [[nodiscard]] RayHit Cast(const Ray& ray, const RayScene& scene, float maxDistance = std::numeric_limits<float>::infinity());
+
+    // Nearest hit for every ray, hits is resized to rays.Size().
+    // The scene is walked one primitive at a time with the rays in the inner loop, so the tests vectorize.
+    void Cast(const RayBatch& rays, const RayScene& scene, std::vector<RayHit>& hits, float maxDistance = std::numeric_limits<float>::infinity());
+}
@@ -0,0 +1,346 @@
+#include "Reduction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace
+{
+    // Points per leaf, the unit of work the result is built from; never depends on the thread count
+    constexpr size_t g_LeafSize{ 1024 };
+    // Partial sums per running value; the ten sums of the moments only stay in registers with fewer lanes
+    constexpr size_t g_LaneCount{ 16 };
+    constexpr size_t g_MomentLaneCount{ 8 };
+    // A thread is only worth starting for this many leaves
+    constexpr size_t g_MinLeavesPerThread{ 16 };
+
+    size_t LeafCount(size_t count)
+    {
+        return (count + g_LeafSize - 1) / g_LeafSize;
+    }
+
+    // Calls leaf(index, first, last) for every leaf, spread over up to threadCount threads
+    template <typename Leaf>
+    void ForEachLeaf(size_t count, unsigned threadCount, const Leaf& leaf)
+    {
+        const size_t leafCount{ LeafCount(count) };
+        const size_t requested{ threadCount == 0 ? reduction::DefaultThreadCount() : threadCount };
+        const size_t threads{ std::max<size_t>(1, std::min(requested, leafCount / g_MinLeavesPerThread)) };
+
+        const auto work{ [&](size_t thread)
+            {
+                const size_t firstLeaf{ leafCount * thread / threads };
+                const size_t lastLeaf{ leafCount * (thread + 1) / threads };
+                for (size_t idx{ firstLeaf }; idx < lastLeaf; ++idx)
+                {
+                    leaf(idx, idx * g_LeafSize, std::min(count, (idx + 1) * g_LeafSize));
+                }
+            } };
+
+        std::vector<std::thread> workers{};
+        workers.reserve(threads - 1);
+        for (size_t thread{ 1 }; thread < threads; ++thread) workers.emplace_back(work, thread);
+        work(0);
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    // Fixed shape binary tree over the leaf results, combine(a, b) folds b into a
+    template <typename Partial, typename Combine>
+    Partial CombinePairwise(std::vector<Partial>& partials, const Combine& combine)
+    {
+        for (size_t stride{ 1 }; stride < partials.size(); stride *= 2)
+        {
+            for (size_t idx{}; idx + stride < partials.size(); idx += 2 * stride) combine(partials[idx], partials[idx + stride]);
+        }
+        return partials.front();
+    }
+
+    // Sums the lanes of sums[0 .. Count) in a fixed order
+    template <size_t Count, size_t Lanes>
+    void AddLanes(const float (&sums)[Count][Lanes], double (&totals)[Count])
+    {
+        for (size_t sum{}; sum < Count; ++sum)
+        {
+            double total{};
+            for (size_t lane{}; lane < Lanes; ++lane) total += sums[sum][lane];
+            totals[sum] = total;
+        }
+    }
+
+    struct SumPartial
+    {
+        double sums[4]{};
+    };
+
+    struct BoundsPartial
+    {
+        float min[3]{ std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() };
+        float max[3]{ -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() };
+    };
+
+    // weight, weighted offsets from the reference and their weighted products xx xy xz yy yz zz
+    struct MomentPartial
+    {
+        double sums[10]{};
+    };
+}
+
+namespace reduction
+{
+    unsigned DefaultThreadCount()
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    ThreeBlade Sum(const PointBatch& points, unsigned threadCount)
+    {
+        const size_t count{ points.Size() };
+        if (count == 0) return ThreeBlade{ 0, 0, 0, 0 };
+
+        const float* x{ points.Component(0) };
+        const float* y{ points.Component(1) };
+        const float* z{ points.Component(2) };
+        const float* w{ points.Component(3) };
+
+        std::vector<SumPartial> partials(LeafCount(count));
+        ForEachLeaf(count, threadCount, [&](size_t leaf, size_t first, size_t last)
+            {
+                float sums[4][g_LaneCount]{};
+                size_t idx{ first };
+                for (; idx + g_LaneCount <= last; idx += g_LaneCount)
+                {
+                    FLYFISH_VECTORIZE
+                    for (size_t lane{}; lane < g_LaneCount; ++lane)
+                    {
+                        const size_t point{ idx + lane };
+                        sums[0][lane] += x[point];
+                        sums[1][lane] += y[point];
+                        sums[2][lane] += z[point];
+                        sums[3][lane] += w[point];
+                    }
+                }
+                //the tail of the last leaf goes into the first lane
+                for (; idx < last; ++idx)
+                {
+                    sums[0][0] += x[idx];
+                    sums[1][0] += y[idx];
+                    sums[2][0] += z[idx];
+                    sums[3][0] += w[idx];
+                }
+                AddLanes(sums, partials[leaf].sums);
+            });
+
+        const SumPartial total{ CombinePairwise(partials, [](SumPartial& a, const SumPartial& b)
+            {
+                for (size_t sum{}; sum < 4; ++sum) a.sums[sum] += b.sums[sum];
+            }) };
+        return ThreeBlade{
+            static_cast<float>(total.sums[0]), static_cast<float>(total.sums[1]),
+            static_cast<float>(total.sums[2]), static_cast<float>(total.sums[3]) };
+    }
+
+    ThreeBlade Centroid(const PointBatch& points, unsigned threadCount)
+    {
+        const ThreeBlade sum{ Sum(points, threadCount) };
+        if (sum[3] == 0) return sum;
+        return ThreeBlade{ sum[0] / sum[3], sum[1] / sum[3], sum[2] / sum[3] };
+    }
+
+    Box Bounds(const PointBatch& points, unsigned threadCount)
+    {
+        const size_t count{ points.Size() };
+        const float* x{ points.Component(0) };
+        const float* y{ points.Component(1) };
+        const float* z{ points.Component(2) };
+        const float* w{ points.Component(3) };
+
+        std::vector<BoundsPartial> partials(std::max<size_t>(1, LeafCount(count)));
+        ForEachLeaf(count, threadCount, [&](size_t leaf, size_t first, size_t last)
+            {
+                constexpr float far{ std::numeric_limits<float>::infinity() };
+                float low[3][g_LaneCount]{}, high[3][g_LaneCount]{};
+                for (size_t lane{}; lane < g_LaneCount; ++lane)
+                {
+                    for (size_t axis{}; axis < 3; ++axis)
+                    {
+                        low[axis][lane] = far;
+                        high[axis][lane] = -far;
+                    }
+                }
+
+                size_t idx{ first };
+                for (; idx + g_LaneCount <= last; idx += g_LaneCount)
+                {
+                    FLYFISH_VECTORIZE
+                    for (size_t lane{}; lane < g_LaneCount; ++lane)
+                    {
+                        const float px{ x[idx + lane] / w[idx + lane] };
+                        const float py{ y[idx + lane] / w[idx + lane] };
+                        const float pz{ z[idx + lane] / w[idx + lane] };
+                        low[0][lane] = px < low[0][lane] ? px : low[0][lane];
+                        low[1][lane] = py < low[1][lane] ? py : low[1][lane];
+                        low[2][lane] = pz < low[2][lane] ? pz : low[2][lane];
+                        high[0][lane] = px > high[0][lane] ? px : high[0][lane];
+                        high[1][lane] = py > high[1][lane] ? py : high[1][lane];
+                        high[2][lane] = pz > high[2][lane] ? pz : high[2][lane];
+                    }
+                }
+                for (; idx < last; ++idx)
+                {
+                    const float p[3]{ x[idx] / w[idx], y[idx] / w[idx], z[idx] / w[idx] };
+                    for (size_t axis{}; axis < 3; ++axis)
+                    {
+                        low[axis][0] = std::min(low[axis][0], p[axis]);
+                        high[axis][0] = std::max(high[axis][0], p[axis]);
+                    }
+                }
+
+                BoundsPartial& partial{ partials[leaf] };
+                for (size_t axis{}; axis < 3; ++axis)
+                {
+                    partial.min[axis] = *std::min_element(low[axis], low[axis] + g_LaneCount);
+                    partial.max[axis] = *std::max_element(high[axis], high[axis] + g_LaneCount);
+                }
+            });
+
+        const BoundsPartial total{ CombinePairwise(partials, [](BoundsPartial& a, const BoundsPartial& b)
+            {
+                for (size_t axis{}; axis < 3; ++axis)
+                {
+                    a.min[axis] = std::min(a.min[axis], b.min[axis]);
+                    a.max[axis] = std::max(a.max[axis], b.max[axis]);
+                }
+            }) };
+        return Box{ ThreeBlade{ total.min[0], total.min[1], total.min[2] }, ThreeBlade{ total.max[0], total.max[1], total.max[2] } };
+    }
+
+    void BoundingPlanes(const PointBatch& points, const std::vector<ThreeBlade>& directions, PlaneBatch& out, unsigned threadCount)
+    {
+        const size_t count{ points.Size() };
+        const size_t directionCount{ directions.size() };
+        const float* x{ points.Component(0) };
+        const float* y{ points.Component(1) };
+        const float* z{ points.Component(2) };
+        const float* w{ points.Component(3) };
+
+        std::vector<float> units(directionCount * 3);
+        for (size_t direction{}; direction < directionCount; ++direction)
+        {
+            const ThreeBlade& d{ directions[direction] };
+            const float length{ std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) };
+            for (size_t axis{}; axis < 3; ++axis) units[direction * 3 + axis] = d[axis] / length;
+        }
+
+        //highest point along every direction, leaf after leaf
+        const size_t leafCount{ LeafCount(count) };
+        std::vector<float> heights(leafCount * directionCount);
+        ForEachLeaf(count, threadCount, [&](size_t leaf, size_t first, size_t last)
+            {
+                for (size_t direction{}; direction < directionCount; ++direction)
+                {
+                    const float dx{ units[direction * 3] }, dy{ units[direction * 3 + 1] }, dz{ units[direction * 3 + 2] };
+                    float high[g_LaneCount];
+                    std::fill(high, high + g_LaneCount, -std::numeric_limits<float>::infinity());
+
+                    size_t idx{ first };
+                    for (; idx + g_LaneCount <= last; idx += g_LaneCount)
+                    {
+                        FLYFISH_VECTORIZE
+                        for (size_t lane{}; lane < g_LaneCount; ++lane)
+                        {
+                            const size_t point{ idx + lane };
+                            const float height{ (dx * x[point] + dy * y[point] + dz * z[point]) / w[point] };
+                            high[lane] = height > high[lane] ? height : high[lane];
+                        }
+                    }
+                    for (; idx < last; ++idx) high[0] = std::max(high[0], (dx * x[idx] + dy * y[idx] + dz * z[idx]) / w[idx]);
+                    heights[leaf * directionCount + direction] = *std::max_element(high, high + g_LaneCount);
+                }
+            });
+
+        out.Clear();
+        for (size_t direction{}; direction < directionCount; ++direction)
+        {
+            float height{ -std::numeric_limits<float>::infinity() };
+            for (size_t leaf{}; leaf < leafCount; ++leaf) height = std::max(height, heights[leaf * directionCount + direction]);
+            out.PushBack(OneBlade{ -height, units[direction * 3], units[direction * 3 + 1], units[direction * 3 + 2] });
+        }
+    }
+
+    PointMoments Moments(const PointBatch& points, unsigned threadCount)
+    {
+        const size_t count{ points.Size() };
+        if (count == 0) return PointMoments{};
+
+        const float* x{ points.Component(0) };
+        const float* y{ points.Component(1) };
+        const float* z{ points.Component(2) };
+        const float* w{ points.Component(3) };
+
+        //offsets from the first point keep the float products small, and it is the same point for every thread count
+        const ThreeBlade first{ points.Get(0) };
+        const float rx{ first[0] / first[3] }, ry{ first[1] / first[3] }, rz{ first[2] / first[3] };
+
+        std::vector<MomentPartial> partials(LeafCount(count));
+        ForEachLeaf(count, threadCount, [&](size_t leaf, size_t firstPoint, size_t last)
+            {
+                float sums[10][g_MomentLaneCount]{};
+                size_t idx{ firstPoint };
+                for (; idx + g_MomentLaneCount <= last; idx += g_MomentLaneCount)
+                {
+                    FLYFISH_VECTORIZE
+                    for (size_t lane{}; lane < g_MomentLaneCount; ++lane)
+                    {
+                        const size_t point{ idx + lane };
+                        const float weight{ w[point] };
+                        const float dx{ x[point] / weight - rx }, dy{ y[point] / weight - ry }, dz{ z[point] / weight - rz };
+                        const float wx{ weight * dx }, wy{ weight * dy }, wz{ weight * dz };
+                        sums[0][lane] += weight;
+                        sums[1][lane] += wx;
+                        sums[2][lane] += wy;
+                        sums[3][lane] += wz;
+                        sums[4][lane] += wx * dx;
+                        sums[5][lane] += wx * dy;
+                        sums[6][lane] += wx * dz;
+                        sums[7][lane] += wy * dy;
+                        sums[8][lane] += wy * dz;
+                        sums[9][lane] += wz * dz;
+                    }
+                }
+                for (; idx < last; ++idx)
+                {
+                    const float weight{ w[idx] };
+                    const float dx{ x[idx] / weight - rx }, dy{ y[idx] / weight - ry }, dz{ z[idx] / weight - rz };
+                    const float wx{ weight * dx }, wy{ weight * dy }, wz{ weight * dz };
+                    const float values[10]{ weight, wx, wy, wz, wx * dx, wx * dy, wx * dz, wy * dy, wy * dz, wz * dz };
+                    for (size_t sum{}; sum < 10; ++sum) sums[sum][0] += values[sum];
+                }
+                AddLanes(sums, partials[leaf].sums);
+            });
+
+        const MomentPartial total{ CombinePairwise(partials, [](MomentPartial& a, const MomentPartial& b)
+            {
+                for (size_t sum{}; sum < 10; ++sum) a.sums[sum] += b.sums[sum];
+            }) };
+
+        PointMoments moments{};
+        const double weight{ total.sums[0] };
+        moments.weight = static_cast<float>(weight);
+        if (weight == 0) return moments;
+
+        const double mean[3]{ total.sums[1] / weight, total.sums[2] / weight, total.sums[3] / weight };
+        moments.centroid = ThreeBlade{ static_cast<float>(rx + mean[0]), static_cast<float>(ry + mean[1]), static_cast<float>(rz + mean[2]) };
+
+        //E[d d^T] - E[d] E[d]^T, shifting by the reference does not change the covariance
+        const size_t products[3][3]{ { 4, 5, 6 }, { 5, 7, 8 }, { 6, 8, 9 } };
+        for (size_t row{}; row < 3; ++row)
+        {
+            for (size_t column{}; column < 3; ++column)
+            {
+                moments.covariance[row][column] = static_cast<float>(total.sums[products[row][column]] / weight - mean[row] * mean[column]);
+            }
+        }
+        return moments;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+#include "Raycast.h"
+
+// Weighted second moments of a point set, every point weighted by its e123 coordinate
+struct PointMoments
+{
+    float weight{};
+    ThreeBlade centroid{ 0, 0, 0 };
+    // Weighted covariance around the centroid, divided by the total weight
+    float covariance[3][3]{};
+};
+
+// Reductions split the batch into fixed leaves of points that are summed in vector lanes, then add
+// the leaf results up pairwise in double. Threads only decide who computes which leaf, so the
+// result is the same bit for bit for every thread count. threadCount 0 uses every hardware thread.
+namespace reduction
+{
+    [[nodiscard]] unsigned DefaultThreadCount();
+
+    // Sum of the points as they are stored, a point whose weight is the total weight.
+    // Points with weight w count w times, the way the PGA sum of weighted points works.
+    [[nodiscard]] ThreeBlade Sum(const PointBatch& points, unsigned threadCount = 0);
+    // Sum normalized to weight 1, the weighted centroid
+    [[nodiscard]] ThreeBlade Centroid(const PointBatch& points, unsigned threadCount = 0);
+
+    // Axis aligned bounds of the normalized points
+    [[nodiscard]] Box Bounds(const PointBatch& points, unsigned threadCount = 0);
+    // Tightest plane per direction (w = 0) with every point behind it, (plane & point) <= 0 like ConvexShape faces
+    void BoundingPlanes(const PointBatch& points, const std::vector<ThreeBlade>& directions, PlaneBatch& out, unsigned threadCount = 0);
+
+    [[nodiscard]] PointMoments Moments(const PointBatch& points, unsigned threadCount = 0);
+}
@@ -0,0 +1,165 @@
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "Reduction.h"
+
+namespace
+{
+    // A thread is only worth starting for this many nodes of one level
+    constexpr size_t g_MinNodesPerThread{ 4096 };
+}
+
+void SceneGraph::Reserve(size_t count)
+{
+    m_Parents.reserve(count);
+    m_Slots.reserve(count);
+    m_Depths.reserve(count);
+    m_Nodes.reserve(count);
+    m_ParentSlots.reserve(count);
+    m_Dirty.reserve(count);
+    m_Locals.Reserve(count);
+    m_Worlds.Reserve(count);
+}
+
+void SceneGraph::Clear()
+{
+    m_Parents.clear();
+    m_Slots.clear();
+    m_Depths.clear();
+    m_Nodes.clear();
+    m_ParentSlots.clear();
+    m_Dirty.clear();
+    m_Locals.Clear();
+    m_Worlds.Clear();
+    m_LevelStarts.clear();
+    m_Ordered = true;
+}
+
+uint32_t SceneGraph::Add(const Motor& local, uint32_t parent)
+{
+    const uint32_t node{ static_cast<uint32_t>(Size()) };
+    m_Parents.push_back(parent);
+    m_Depths.push_back(parent == NoParent ? 0 : m_Depths[parent] + 1);
+    m_Slots.push_back(node);
+
+    m_Nodes.push_back(node);
+    m_ParentSlots.push_back(parent == NoParent ? NoParent : m_Slots[parent]);
+    m_Dirty.push_back(1);
+    m_Locals.PushBack(local);
+    m_Worlds.PushBack(local);
+    m_Ordered = false;
+    return node;
+}
+
+void SceneGraph::SetLocal(uint32_t node, const Motor& local)
+{
+    const uint32_t slot{ m_Slots[node] };
+    m_Locals.Set(slot, local);
+    m_Dirty[slot] = 1;
+}
+
+void SceneGraph::Update(unsigned threadCount)
+{
+    if (!m_Ordered) Reorder();
+
+    const size_t requested{ threadCount == 0 ? reduction::DefaultThreadCount() : threadCount };
+    for (size_t level{}; level < LevelCount(); ++level)
+    {
+        const size_t first{ m_LevelStarts[level] };
+        const size_t last{ m_LevelStarts[level + 1] };
+        const size_t threads{ std::max<size_t>(1, std::min(requested, (last - first) / g_MinNodesPerThread)) };
+        if (threads == 1)
+        {
+            UpdateSlots(first, last);
+            continue;
+        }
+
+        //every level only reads the one above, which is finished once the workers are joined
+        const auto work{ [&](size_t thread)
+            {
+                UpdateSlots(first + (last - first) * thread / threads, first + (last - first) * (thread + 1) / threads);
+            } };
+        std::vector<std::thread> workers{};
+        workers.reserve(threads - 1);
+        for (size_t thread{ 1 }; thread < threads; ++thread) workers.emplace_back(work, thread);
+        work(0);
+        for (std::thread& worker : workers) worker.join();
+    }
+    std::fill(m_Dirty.begin(), m_Dirty.end(), uint8_t{ 0 });
+}
+
+void SceneGraph::UpdateSlots(size_t first, size_t last)
+{
+    const float* local[8]{};
+    float* world[8]{};
+    for (size_t component{}; component < 8; ++component)
+    {
+        local[component] = m_Locals.Component(component);
+        world[component] = m_Worlds.Component(component);
+    }
+
+    for (size_t slot{ first }; slot < last; ++slot)
+    {
+        //a dirty parent passes its flag down, so whole subtrees follow one changed node
+        const uint32_t parent{ m_ParentSlots[slot] };
+        if (parent != NoParent && m_Dirty[parent]) m_Dirty[slot] = 1;
+        if (!m_Dirty[slot]) continue;
+
+        if (parent == NoParent)
+        {
+            for (size_t component{}; component < 8; ++component) world[component][slot] = local[component][slot];
+            continue;
+        }
+
+        //Motor * Motor written out, parent world times local
+        float a[8]{}, b[8]{};
+        for (size_t component{}; component < 8; ++component)
+        {
+            a[component] = world[component][parent];
+            b[component] = local[component][slot];
+        }
+        world[0][slot] = b[0] * a[0] - b[6] * a[6] - b[5] * a[5] - b[4] * a[4];
+        world[1][slot] = b[1] * a[0] + b[0] * a[1] - b[6] * a[2] + b[5] * a[3] + b[2] * a[6] - b[3] * a[5] - b[7] * a[4] - b[4] * a[7];
+        world[2][slot] = b[2] * a[0] + b[6] * a[1] + b[0] * a[2] - b[4] * a[3] - b[1] * a[6] - b[7] * a[5] + b[3] * a[4] - b[5] * a[7];
+        world[3][slot] = b[3] * a[0] - b[5] * a[1] + b[4] * a[2] + b[0] * a[3] - b[7] * a[6] + b[1] * a[5] - b[2] * a[4] - b[6] * a[7];
+        world[4][slot] = b[4] * a[0] + b[5] * a[6] - b[6] * a[5] + b[0] * a[4];
+        world[5][slot] = b[5] * a[0] - b[4] * a[6] + b[0] * a[5] + b[6] * a[4];
+        world[6][slot] = b[6] * a[0] + b[0] * a[6] + b[4] * a[5] - b[5] * a[4];
+        world[7][slot] = b[7] * a[0] + b[4] * a[1] + b[5] * a[2] + b[6] * a[3] + b[3] * a[6] + b[2] * a[5] + b[1] * a[4] + b[0] * a[7];
+    }
+}
+
+void SceneGraph::Reorder()
+{
+    //counting sort on depth, stable so siblings keep the order they were added in
+    const size_t count{ Size() };
+    const uint32_t levels{ count == 0 ? 0 : *std::max_element(m_Depths.begin(), m_Depths.end()) + 1 };
+    m_LevelStarts.assign(levels + 1, 0);
+    for (const uint32_t depth : m_Depths) ++m_LevelStarts[depth + 1];
+    for (size_t level{}; level < levels; ++level) m_LevelStarts[level + 1] += m_LevelStarts[level];
+
+    std::vector<size_t> next{ m_LevelStarts.begin(), m_LevelStarts.end() - 1 };
+    std::vector<uint32_t> nodes(count);
+    MotorBatch locals(count);
+    for (uint32_t node{}; node < count; ++node)
+    {
+        const size_t slot{ next[m_Depths[node]]++ };
+        nodes[slot] = node;
+        locals.Set(slot, m_Locals.Get(m_Slots[node]));
+    }
+    for (size_t slot{}; slot < count; ++slot) m_Slots[nodes[slot]] = static_cast<uint32_t>(slot);
+    for (size_t slot{}; slot < count; ++slot)
+    {
+        const uint32_t parent{ m_Parents[nodes[slot]] };
+        m_ParentSlots[slot] = parent == NoParent ? NoParent : m_Slots[parent];
+    }
+
+    //world motors are recomputed for everything that moved, cheaper than carrying them along
+    m_Nodes = std::move(nodes);
+    m_Locals = std::move(locals);
+    std::fill(m_Dirty.begin(), m_Dirty.end(), uint8_t{ 1 });
+    m_Ordered = true;
+}
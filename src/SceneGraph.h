@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Hierarchy of nodes with a local motor each, world = world of the parent * local.
+// Nodes live in breadth-first order in structure of arrays form, one level after the other, so a level only reads
+// the level above it: an update walks the levels top-down and the nodes of one level can be split over threads.
+// SetLocal marks a node dirty and Update only recomposes dirty nodes and everything below them.
+class SceneGraph
+{
+public:
+    static constexpr uint32_t NoParent{ 0xFFFFFFFFu };
+
+    [[nodiscard]] size_t Size() const { return m_Slots.size(); }
+    [[nodiscard]] size_t LevelCount() const { return m_LevelStarts.empty() ? 0 : m_LevelStarts.size() - 1; }
+
+    void Reserve(size_t count);
+    void Clear();
+    // Returns the handle of the new node, handles count up from 0 and never change. parent must already exist.
+    uint32_t Add(const Motor& local, uint32_t parent = NoParent);
+
+    [[nodiscard]] uint32_t Parent(uint32_t node) const { return m_Parents[node]; }
+    [[nodiscard]] Motor Local(uint32_t node) const { return m_Locals.Get(m_Slots[node]); }
+    void SetLocal(uint32_t node, const Motor& local);
+    // As of the last Update
+    [[nodiscard]] Motor World(uint32_t node) const { return m_Worlds.Get(m_Slots[node]); }
+
+    // Recomposes the world motors of dirty nodes and their subtrees. Levels with enough dirty work are split over
+    // up to threadCount threads, 0 uses every hardware thread; the result does not depend on the thread count.
+    void Update(unsigned threadCount = 1);
+
+    // Breadth-first storage: slot i holds node NodeAt(i), the slots of level l are [LevelStart(l), LevelStart(l + 1))
+    [[nodiscard]] uint32_t NodeAt(size_t slot) const { return m_Nodes[slot]; }
+    [[nodiscard]] size_t LevelStart(size_t level) const { return m_LevelStarts[level]; }
+    [[nodiscard]] const MotorBatch& Worlds() const { return m_Worlds; }
+
+private:
+    void Reorder();
+    void UpdateSlots(size_t first, size_t last);
+
+    // Per handle
+    std::vector<uint32_t> m_Parents{};
+    std::vector<uint32_t> m_Slots{};
+    std::vector<uint32_t> m_Depths{};
+
+    // Per slot; nodes added since the last Update sit at the end until it puts them in order
+    std::vector<uint32_t> m_Nodes{};
+    std::vector<uint32_t> m_ParentSlots{};
+    std::vector<uint8_t> m_Dirty{};
+    MotorBatch m_Locals{};
+    MotorBatch m_Worlds{};
+    std::vector<size_t> m_LevelStarts{};
+    bool m_Ordered{ true };
+};
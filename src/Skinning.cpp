@@ -0,0 +1,219 @@
+#include "Skinning.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Points skinned per pass, small enough that the blended motors stay in L1
+    constexpr size_t g_ChunkSize{ 64 };
+
+    struct MotorComponents
+    {
+        float s, t1, t2, t3, r1, r2, r3, q;
+    };
+
+    // A = 1 / |rotor|, B = A^3 (s q - t.r)
+    inline MotorComponents RenormalizeComponents(const MotorComponents& m)
+    {
+        const float a{ 1 / std::sqrt(m.s * m.s + m.r1 * m.r1 + m.r2 * m.r2 + m.r3 * m.r3) };
+        const float b{ a * a * a * (m.s * m.q - (m.t1 * m.r1 + m.t2 * m.r2 + m.t3 * m.r3)) };
+        return MotorComponents{
+            m.s * a,
+            m.t1 * a + m.r1 * b,
+            m.t2 * a + m.r2 * b,
+            m.t3 * a + m.r3 * b,
+            m.r1 * a,
+            m.r2 * a,
+            m.r3 * a,
+            m.q * a - m.s * b };
+    }
+
+    // The sandwich M P ~M expanded per component. ~M divides by the squared rotor norm, which
+    // leaves the weight of the point unchanged; pass 1 for it when the motor is known to be normalized.
+    inline void TransformComponents(const MotorComponents& m, float invNormSquared,
+        float x, float y, float z, float w, float& outX, float& outY, float& outZ)
+    {
+        const float ss{ m.s * m.s }, r11{ m.r1 * m.r1 }, r22{ m.r2 * m.r2 }, r33{ m.r3 * m.r3 };
+        const float sr1{ m.s * m.r1 }, sr2{ m.s * m.r2 }, sr3{ m.s * m.r3 };
+        const float r12{ m.r1 * m.r2 }, r13{ m.r1 * m.r3 }, r23{ m.r2 * m.r3 };
+
+        const float tx{ -m.s * m.t1 - m.t2 * m.r3 + m.t3 * m.r2 - m.r1 * m.q };
+        const float ty{ -m.s * m.t2 + m.t1 * m.r3 - m.t3 * m.r1 - m.r2 * m.q };
+        const float tz{ -m.s * m.t3 - m.t1 * m.r2 + m.t2 * m.r1 - m.r3 * m.q };
+
+        outX = (x * (ss + r11 - r22 - r33) + 2 * (y * (sr3 + r12) + z * (r13 - sr2) + w * tx)) * invNormSquared;
+        outY = (y * (ss - r11 + r22 - r33) + 2 * (x * (r12 - sr3) + z * (sr1 + r23) + w * ty)) * invNormSquared;
+        outZ = (z * (ss - r11 - r22 + r33) + 2 * (x * (sr2 + r13) + y * (r23 - sr1) + w * tz)) * invNormSquared;
+    }
+
+    MotorComponents ToComponents(const Motor& motor)
+    {
+        return MotorComponents{ motor[0], motor[1], motor[2], motor[3], motor[4], motor[5], motor[6], motor[7] };
+    }
+
+    Motor ToMotor(const MotorComponents& m)
+    {
+        return Motor{ m.s, m.t1, m.t2, m.t3, m.r1, m.r2, m.r3, m.q };
+    }
+
+    // Weight of an influence, negated when its rotor points away from the reference rotor.
+    // copysign instead of a branch: which way round a motor is stored is a coin flip the predictor cannot learn.
+    // The sign is flipped rather than overwritten, spline weights are negative on purpose.
+    inline float AlignedWeight(const Motor& motor, const Motor& reference, float weight)
+    {
+        const float dot{ motor[0] * reference[0] + motor[4] * reference[4] + motor[5] * reference[5] + motor[6] * reference[6] };
+        return weight * std::copysign(1.f, dot);
+    }
+}
+
+SkinWeights::SkinWeights(size_t influencesPerPoint)
+    : m_InfluencesPerPoint{ influencesPerPoint }
+{
+}
+
+void SkinWeights::Reserve(size_t pointCount)
+{
+    m_Indices.reserve(pointCount * m_InfluencesPerPoint);
+    m_Weights.reserve(pointCount * m_InfluencesPerPoint);
+}
+
+void SkinWeights::Clear()
+{
+    m_Indices.clear();
+    m_Weights.clear();
+    m_Size = 0;
+}
+
+void SkinWeights::PushBack(const int* indices, const float* weights)
+{
+    m_Indices.insert(m_Indices.end(), indices, indices + m_InfluencesPerPoint);
+    m_Weights.insert(m_Weights.end(), weights, weights + m_InfluencesPerPoint);
+    ++m_Size;
+}
+
+namespace skinning
+{
+    Motor Renormalize(const Motor& motor)
+    {
+        return ToMotor(RenormalizeComponents(ToComponents(motor)));
+    }
+
+    Motor Blend(const Motor* motors, const float* weights, size_t count)
+    {
+        Motor sum{ 0, 0, 0, 0, 0, 0, 0, 0 };
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            const float weight{ AlignedWeight(motors[idx], motors[0], weights[idx]) };
+            for (size_t component{}; component < 8; ++component)
+            {
+                sum[component] += motors[idx][component] * weight;
+            }
+        }
+        return Renormalize(sum);
+    }
+
+    ThreeBlade Transform(const Motor& motor, const ThreeBlade& point)
+    {
+        const MotorComponents m{ ToComponents(motor) };
+        const float invNormSquared{ 1 / (m.s * m.s + m.r1 * m.r1 + m.r2 * m.r2 + m.r3 * m.r3) };
+        ThreeBlade result{ 0, 0, 0, point[3] };
+        TransformComponents(m, invNormSquared, point[0], point[1], point[2], point[3], result[0], result[1], result[2]);
+        return result;
+    }
+
+    void TransformPoints(const Motor& motor, const PointBatch& points, PointBatch& out)
+    {
+        const size_t count{ points.Size() };
+        out.Resize(count);
+
+        //one motor for every point, so the sandwich collapses to a 3x4 matrix read off the basis points
+        float rows[3][4]{};
+        for (size_t column{}; column < 4; ++column)
+        {
+            ThreeBlade basis{ 0, 0, 0, 0 };
+            basis[column] = 1;
+            const ThreeBlade image{ Transform(motor, basis) };
+            for (size_t row{}; row < 3; ++row) rows[row][column] = image[row];
+        }
+
+        const float* x{ points.Component(0) };
+        const float* y{ points.Component(1) };
+        const float* z{ points.Component(2) };
+        const float* w{ points.Component(3) };
+        float* outX{ out.Component(0) };
+        float* outY{ out.Component(1) };
+        float* outZ{ out.Component(2) };
+        float* outW{ out.Component(3) };
+
+        FLYFISH_VECTORIZE
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            outX[idx] = rows[0][0] * x[idx] + rows[0][1] * y[idx] + rows[0][2] * z[idx] + rows[0][3] * w[idx];
+            outY[idx] = rows[1][0] * x[idx] + rows[1][1] * y[idx] + rows[1][2] * z[idx] + rows[1][3] * w[idx];
+            outZ[idx] = rows[2][0] * x[idx] + rows[2][1] * y[idx] + rows[2][2] * z[idx] + rows[2][3] * w[idx];
+            outW[idx] = w[idx];
+        }
+    }
+
+    void SkinPoints(const PointBatch& bindPoints, const SkinWeights& weights, const std::vector<Motor>& motors, PointBatch& out)
+    {
+        const size_t influences{ weights.InfluencesPerPoint() };
+        //without influences there is no motor to blend, nor a reference to align the rotors with
+        const size_t count{ influences == 0 ? 0 : std::min(bindPoints.Size(), weights.Size()) };
+        out.Resize(count);
+        if (count == 0) return;
+
+        const float* x{ bindPoints.Component(0) };
+        const float* y{ bindPoints.Component(1) };
+        const float* z{ bindPoints.Component(2) };
+        const float* w{ bindPoints.Component(3) };
+        float* outX{ out.Component(0) };
+        float* outY{ out.Component(1) };
+        float* outZ{ out.Component(2) };
+        float* outW{ out.Component(3) };
+
+        //blended motors of one chunk, component after component so the transform loop vectorizes
+        float blended[8][g_ChunkSize];
+
+        for (size_t first{}; first < count; first += g_ChunkSize)
+        {
+            const size_t chunk{ std::min(g_ChunkSize, count - first) };
+            const int* indices{ weights.Indices() + first * influences };
+            const float* pointWeights{ weights.Weights() + first * influences };
+
+            //the gathers cannot vectorize, but indices and weights are read strictly in order
+            for (size_t point{}; point < chunk; ++point)
+            {
+                const Motor& reference{ motors[indices[0]] };
+                float sum[8]{};
+                for (size_t influence{}; influence < influences; ++influence)
+                {
+                    const Motor& motor{ motors[indices[influence]] };
+                    const float weight{ AlignedWeight(motor, reference, pointWeights[influence]) };
+                    for (size_t component{}; component < 8; ++component)
+                    {
+                        sum[component] += motor[component] * weight;
+                    }
+                }
+                for (size_t component{}; component < 8; ++component)
+                {
+                    blended[component][point] = sum[component];
+                }
+                indices += influences;
+                pointWeights += influences;
+            }
+
+            FLYFISH_VECTORIZE
+            for (size_t point{}; point < chunk; ++point)
+            {
+                const MotorComponents motor{ RenormalizeComponents(MotorComponents{
+                    blended[0][point], blended[1][point], blended[2][point], blended[3][point],
+                    blended[4][point], blended[5][point], blended[6][point], blended[7][point] }) };
+                const size_t idx{ first + point };
+                TransformComponents(motor, 1, x[idx], y[idx], z[idx], w[idx], outX[idx], outY[idx], outZ[idx]);
+                outW[idx] = w[idx];
+            }
+        }
+    }
+}
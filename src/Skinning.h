@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Skinning influences with a fixed number of motors per point.
+// Indices and weights are stored point after point, influence after influence,
+// so the skinning kernel reads both front to back in a single pass.
+class SkinWeights
+{
+public:
+    explicit SkinWeights(size_t influencesPerPoint);
+
+    [[nodiscard]] size_t Size() const { return m_Size; }
+    [[nodiscard]] size_t InfluencesPerPoint() const { return m_InfluencesPerPoint; }
+
+    void Reserve(size_t pointCount);
+    void Clear();
+    // indices and weights hold InfluencesPerPoint() entries each, unused influences get weight 0
+    void PushBack(const int* indices, const float* weights);
+
+    [[nodiscard]] const int* Indices() const { return m_Indices.data(); }
+    [[nodiscard]] const float* Weights() const { return m_Weights.data(); }
+
+private:
+    size_t m_InfluencesPerPoint;
+    size_t m_Size{};
+    std::vector<int> m_Indices{};
+    std::vector<float> m_Weights{};
+};
+
+namespace skinning
+{
+    // Projects a motor back onto the rigid motions: unit rotor part and no e0123 left over
+    // once the translation is taken out. Blended motors drift off both, FlyFish's Normalized() only fixes the first.
+    [[nodiscard]] Motor Renormalize(const Motor& motor);
+
+    // Weighted sum of motors followed by Renormalize, the PGA form of dual quaternion blending.
+    // Weights may be negative, like the outer Catmull-Rom weights of a spline. Motors with a rotor opposite to the first one are flipped,
+    // M and -M are the same motion but would cancel out.
+    [[nodiscard]] Motor Blend(const Motor* motors, const float* weights, size_t count);
+
+    // (motor * point * ~motor).Grade3() written out, for the hot loops
+    [[nodiscard]] ThreeBlade Transform(const Motor& motor, const ThreeBlade& point);
+    // out[i] = Transform(motor, points[i]), out is resized to points.Size()
+    void TransformPoints(const Motor& motor, const PointBatch& points, PointBatch& out);
+
+    // out[i] = Transform(Blend(motors of point i, weights of point i), bindPoints[i]), out is resized to bindPoints.Size().
+    // Weights without influences skin nothing and leave out empty.
+    // Motors stay array of structures: a gather reads one 32 byte motor instead of touching eight component arrays.
+    void SkinPoints(const PointBatch& bindPoints, const SkinWeights& weights, const std::vector<Motor>& motors, PointBatch& out);
+}
@@ -0,0 +1,228 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Keeps lookups short: the table is at most half full
+    constexpr size_t g_MinBuckets{ 16 };
+    // Scaled coordinates are clamped to this before the cast, 2^62 so the neighbor cell still fits in an int64_t
+    constexpr float g_MaxCell{ 4.611686e18f };
+
+    void Canonical(const ThreeBlade& point, float* key)
+    {
+        //ideal points have no position, their direction is compared as given
+        const float scale{ point[3] != 0 ? 1 / point[3] : 1 };
+        for (size_t axis{}; axis < 3; ++axis) key[axis] = point[axis] * scale;
+    }
+
+    void Canonical(const TwoBlade& line, float* key)
+    {
+        //unit direction, or unit moment for lines at infinity
+        const float direction{ line.Norm() };
+        const size_t first{ direction > 0 ? size_t{ 3 } : size_t{ 0 } };
+        const float length{ direction > 0 ? direction : line.VNorm() };
+
+        //the largest component decides the sign, so most near-identical lines agree on it; near a tie between
+        //components of opposite sign they do not, which is why lines are also looked up negated
+        size_t largest{ first };
+        for (size_t component{ first + 1 }; component < first + 3; ++component)
+        {
+            if (std::fabs(line[component]) > std::fabs(line[largest])) largest = component;
+        }
+        const float scale{ length > 0 ? std::copysign(1 / length, line[largest]) : 1 };
+        for (size_t component{}; component < 6; ++component) key[component] = line[component] * scale;
+    }
+
+    uint64_t HashCell(const int64_t* cell, size_t dimensions)
+    {
+        uint64_t hash{};
+        for (size_t axis{}; axis < dimensions; ++axis)
+        {
+            hash = (hash ^ static_cast<uint64_t>(cell[axis])) * 0x9E3779B97F4A7C15ull;
+        }
+        return hash ^ (hash >> 32);
+    }
+}
+
+template <typename Batch>
+SpatialHashSet<Batch>::SpatialHashSet(float tolerance)
+    : m_Tolerance{ tolerance > 0 ? tolerance : 0 }
+    , m_InverseCellSize{ tolerance > 0 ? 1 / (2 * tolerance) : 0 }
+{
+}
+
+template <typename Batch>
+void SpatialHashSet<Batch>::Reserve(size_t count)
+{
+    m_Elements.Reserve(count);
+    m_Keys.reserve(count * Dimensions);
+    m_Next.reserve(count);
+    if (count * 2 > m_Buckets.size()) Rehash(count * 2);
+}
+
+template <typename Batch>
+void SpatialHashSet<Batch>::Clear()
+{
+    m_Elements.Clear();
+    m_Keys.clear();
+    m_Next.clear();
+    std::fill(m_Buckets.begin(), m_Buckets.end(), 0u);
+}
+
+template <typename Batch>
+int SpatialHashSet<Batch>::Find(const Element& element) const
+{
+    float key[Dimensions]{};
+    Canonical(element, key);
+    return FindKey(key);
+}
+
+template <typename Batch>
+uint32_t SpatialHashSet<Batch>::Insert(const Element& element)
+{
+    float key[Dimensions]{};
+    Canonical(element, key);
+    const int found{ FindKey(key) };
+    if (found >= 0) return static_cast<uint32_t>(found);
+
+    if ((Size() + 1) * 2 > m_Buckets.size()) Rehash(std::max(g_MinBuckets, m_Buckets.size() * 2));
+
+    const uint32_t index{ static_cast<uint32_t>(Size()) };
+    m_Elements.PushBack(element);
+    m_Keys.insert(m_Keys.end(), key, key + Dimensions);
+
+    int64_t cell[Dimensions]{};
+    Cell(key, cell);
+    uint32_t& head{ m_Buckets[Bucket(cell)] };
+    m_Next.push_back(head);
+    head = index + 1;
+    return index;
+}
+
+template <typename Batch>
+int SpatialHashSet<Batch>::FindKey(const float* key) const
+{
+    int best{ FindCells(key) };
+    if constexpr (Signless)
+    {
+        float negated[Dimensions]{};
+        for (size_t axis{}; axis < Dimensions; ++axis) negated[axis] = -key[axis];
+        const int flipped{ FindCells(negated) };
+        if (flipped >= 0 && (best < 0 || flipped < best)) best = flipped;
+    }
+    return best;
+}
+
+template <typename Batch>
+int SpatialHashSet<Batch>::FindCells(const float* key) const
+{
+    if (m_Buckets.empty()) return -1;
+
+    //the own cell and, per axis, the neighbor on the side the coordinate is closer to; exact keys only have their own
+    int64_t base[Dimensions]{};
+    int64_t side[Dimensions]{};
+    Cell(key, base);
+    for (size_t axis{}; axis < Dimensions; ++axis)
+    {
+        const float scaled{ key[axis] * m_InverseCellSize };
+        side[axis] = scaled - std::floor(scaled) < 0.5f ? -1 : 1;
+    }
+    const size_t probeCount{ IsExact() ? size_t{ 1 } : size_t{ 1 } << Dimensions };
+
+    int best{ -1 };
+    int64_t cell[Dimensions]{};
+    for (size_t probe{}; probe < probeCount; ++probe)
+    {
+        for (size_t axis{}; axis < Dimensions; ++axis) cell[axis] = base[axis] + ((probe >> axis) & 1 ? side[axis] : 0);
+
+        //buckets are shared by whatever hashes there, the distance test sorts the real matches out
+        for (uint32_t entry{ m_Buckets[Bucket(cell)] }; entry != 0; entry = m_Next[entry - 1])
+        {
+            const uint32_t index{ entry - 1 };
+            if (best >= 0 && index >= static_cast<uint32_t>(best)) continue;
+
+            const float* stored{ m_Keys.data() + index * Dimensions };
+            bool within{ true };
+            for (size_t axis{}; axis < Dimensions; ++axis) within = within && std::fabs(stored[axis] - key[axis]) <= m_Tolerance;
+            if (within) best = static_cast<int>(index);
+        }
+    }
+    return best;
+}
+
+template <typename Batch>
+void SpatialHashSet<Batch>::Rehash(size_t bucketCount)
+{
+    size_t count{ g_MinBuckets };
+    while (count < bucketCount) count *= 2;
+    m_Buckets.assign(count, 0u);
+
+    int64_t cell[Dimensions]{};
+    for (uint32_t index{}; index < m_Next.size(); ++index)
+    {
+        Cell(m_Keys.data() + index * Dimensions, cell);
+        uint32_t& head{ m_Buckets[Bucket(cell)] };
+        m_Next[index] = head;
+        head = index + 1;
+    }
+}
+
+template <typename Batch>
+void SpatialHashSet<Batch>::Cell(const float* key, int64_t* cell) const
+{
+    for (size_t axis{}; axis < Dimensions; ++axis)
+    {
+        if (IsExact())
+        {
+            //+ 0 turns -0 into 0, the two compare equal and have to share a cell
+            const float coordinate{ key[axis] + 0.f };
+            int32_t bits{};
+            std::memcpy(&bits, &coordinate, sizeof(bits));
+            cell[axis] = bits;
+        }
+        else
+        {
+            //fmin and fmax also turn NaN into a bound, casting NaN or anything out of range is undefined
+            const float scaled{ std::fmax(std::fmin(key[axis] * m_InverseCellSize, g_MaxCell), -g_MaxCell) };
+            cell[axis] = static_cast<int64_t>(std::floor(scaled));
+        }
+    }
+}
+
+template <typename Batch>
+size_t SpatialHashSet<Batch>::Bucket(const int64_t* cell) const
+{
+    return static_cast<size_t>(HashCell(cell, Dimensions)) & (m_Buckets.size() - 1);
+}
+
+template class SpatialHashSet<PointBatch>;
+template class SpatialHashSet<LineBatch>;
+
+namespace
+{
+    template <typename Batch>
+    void DeduplicateBatch(const Batch& elements, float tolerance, Batch& unique, std::vector<uint32_t>& remap)
+    {
+        SpatialHashSet<Batch> set{ tolerance };
+        set.Reserve(elements.Size());
+        remap.resize(elements.Size());
+        for (size_t idx{}; idx < elements.Size(); ++idx) remap[idx] = set.Insert(elements.Get(idx));
+        unique = set.Elements();
+    }
+}
+
+namespace dedup
+{
+    void Deduplicate(const PointBatch& points, float tolerance, PointBatch& unique, std::vector<uint32_t>& remap)
+    {
+        DeduplicateBatch(points, tolerance, unique, remap);
+    }
+
+    void Deduplicate(const LineBatch& lines, float tolerance, LineBatch& unique, std::vector<uint32_t>& remap)
+    {
+        DeduplicateBatch(lines, tolerance, unique, remap);
+    }
+}
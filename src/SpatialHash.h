@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+
+// Set of elements where everything within tolerance of a stored element counts as that element.
+// Elements are compared like RoundedEqual, every component at most tolerance apart, but on a canonical form:
+// points divided by their weight, lines scaled to a unit direction and turned so that L and -L mostly share a key.
+// No sign rule is stable for every direction, so lines are also looked up under the negated key.
+// The canonical coordinates are hashed per cell of 2 * tolerance. A match lies in the same cell or in the
+// neighbor on the side nearer to the coordinate, so a lookup probes 2^dimensions cells (8 for points,
+// 64 for lines) instead of comparing against every stored element.
+template <typename Batch>
+class SpatialHashSet
+{
+public:
+    using Element = std::decay_t<decltype(std::declval<const Batch&>().Get(0))>;
+
+    // A tolerance of 0 or less only merges exact matches, which hash their coordinates as they are
+    explicit SpatialHashSet(float tolerance);
+
+    [[nodiscard]] size_t Size() const { return m_Elements.Size(); }
+    [[nodiscard]] float Tolerance() const { return m_Tolerance; }
+    // The stored elements as they were first inserted
+    [[nodiscard]] const Batch& Elements() const { return m_Elements; }
+
+    void Reserve(size_t count);
+    void Clear();
+
+    // Index of the first stored element within tolerance, -1 when there is none
+    [[nodiscard]] int Find(const Element& element) const;
+    // Index of the first stored element within tolerance, or of element itself once it is added
+    uint32_t Insert(const Element& element);
+
+private:
+    static constexpr size_t Dimensions{ std::is_same_v<Element, ThreeBlade> ? 3 : 6 };
+    // L and -L are the same line, a negated point is a different point
+    static constexpr bool Signless{ !std::is_same_v<Element, ThreeBlade> };
+
+    // Probes key and, for lines, -key
+    [[nodiscard]] int FindKey(const float* key) const;
+    [[nodiscard]] int FindCells(const float* key) const;
+    [[nodiscard]] bool IsExact() const { return m_InverseCellSize == 0; }
+    void Cell(const float* key, int64_t* cell) const;
+    void Rehash(size_t bucketCount);
+    [[nodiscard]] size_t Bucket(const int64_t* cell) const;
+
+    float m_Tolerance;
+    float m_InverseCellSize;
+    Batch m_Elements{};
+    // Canonical coordinates, Dimensions per element
+    std::vector<float> m_Keys{};
+    // First element + 1 of every bucket, 0 when empty; the rest of the bucket follows through m_Next
+    std::vector<uint32_t> m_Buckets{};
+    std::vector<uint32_t> m_Next{};
+};
+
+using PointHashSet = SpatialHashSet<PointBatch>;
+using LineHashSet = SpatialHashSet<LineBatch>;
+
+namespace dedup
+{
+    // Merges elements within tolerance of each other in linear expected time. unique receives the first element
+    // of every group in input order and remap[i] the index in unique that input i merged into.
+    // The result equals comparing every element against every earlier unique one with RoundedEqual on the canonical form.
+    void Deduplicate(const PointBatch& points, float tolerance, PointBatch& unique, std::vector<uint32_t>& remap);
+    void Deduplicate(const LineBatch& lines, float tolerance, LineBatch& unique, std::vector<uint32_t>& remap);
+}
@@ -0,0 +1,361 @@
+#include "SweptBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Skinning.h"
+
+namespace
+{
+    constexpr float g_TwoPi{ 6.28318530718f };
+    // Below this many radians per unit of t the motion is treated as a pure translation
+    constexpr float g_MinAngularSpeed{ 1e-6f };
+
+    struct Range
+    {
+        float min{ std::numeric_limits<float>::infinity() };
+        float max{ -std::numeric_limits<float>::infinity() };
+
+        void Include(float value)
+        {
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+    };
+
+    struct Vector
+    {
+        float x, y, z;
+    };
+
+    Vector Cross(const Vector& a, const Vector& b)
+    {
+        return Vector{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    float Dot(const Vector& a, const Vector& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    // Everything about a motion over [t0, t1] that does not depend on the point being swept
+    struct Sweep
+    {
+        Sweep(const ScrewMotion& motion, float t0, float t1)
+            : n{ motion.Axis()[0], motion.Axis()[1], motion.Axis()[2] }
+            , center{ motion.Center()[0], motion.Center()[1], motion.Center()[2] }
+            , speed{ motion.AngularSpeed() }
+            , axialSpeed{ motion.AxialSpeed() }
+            , t0{ t0 }
+            , t1{ t1 }
+            , theta0{ speed * t0 }
+            , theta1{ speed * t1 }
+            , cos0{ std::cos(theta0) }
+            , sin0{ std::sin(theta0) }
+            , cos1{ std::cos(theta1) }
+            , sin1{ std::sin(theta1) }
+        {
+        }
+
+        // Whether the angle with this cosine and sine lies on the arc from theta0 to theta1
+        [[nodiscard]] bool Passes(float cosine, float sine) const
+        {
+            const float span{ theta1 - theta0 };
+            if (span >= g_TwoPi) return true;
+            const float fromStart{ cos0 * sine - sin0 * cosine };
+            const float toEnd{ cosine * sin1 - sine * cos1 };
+            if (span <= g_TwoPi / 2) return fromStart >= 0 && toEnd >= 0;
+            return fromStart >= 0 || toEnd >= 0;
+        }
+
+        Vector n, center;
+        float speed, axialSpeed;
+        float t0, t1, theta0, theta1;
+        float cos0, sin0, cos1, sin1;
+    };
+
+    // Range of d . p(t) for t in [t0, t1], where p(t) is a point (or a direction) that starts at q
+    // and follows the screw. Written out it is g(t) = a + b cos(wt) + c sin(wt) + f t, whose
+    // extremes are the two ends and the stationary points -b sin + c cos + f / w = 0, one pair per turn.
+    // Stationary values drift by 2 pi f / w from turn to turn, so only the first and last of each pair count.
+    Range SweptRange(const Sweep& sweep, const Vector& q, bool isDirection, const Vector& d)
+    {
+        const Vector center{ isDirection ? Vector{} : sweep.center };
+        const Vector relative{ q.x - center.x, q.y - center.y, q.z - center.z };
+        const float dn{ Dot(d, sweep.n) };
+        const float along{ Dot(sweep.n, relative) };
+        const float a{ Dot(d, center) + dn * along };
+        const float b{ Dot(d, relative) - dn * along };
+        const float c{ Dot(d, Cross(sweep.n, relative)) };
+        const float f{ isDirection ? 0.f : sweep.axialSpeed * dn };
+
+        Range range{};
+        range.Include(a + b * sweep.cos0 + c * sweep.sin0 + f * sweep.t0);
+        range.Include(a + b * sweep.cos1 + c * sweep.sin1 + f * sweep.t1);
+        if (sweep.speed < g_MinAngularSpeed) return range;
+
+        //in terms of the angle theta = w t the drift is f / w per radian
+        const float drift{ f / sweep.speed };
+        const float radius{ std::sqrt(b * b + c * c) };
+        if (!(radius > std::fabs(drift))) return range;
+
+        //stationary angles are phase + offset and phase + pi - offset with cos(phase) = b / radius
+        //and sin(offset) = drift / radius, their cosines and sines follow without more trig calls
+        const float cosPhase{ b / radius }, sinPhase{ c / radius };
+        const float sinOffset{ drift / radius };
+        const float cosOffset{ std::sqrt(1 - sinOffset * sinOffset) };
+        const float cosines[2]{ cosPhase * cosOffset - sinPhase * sinOffset, -(cosPhase * cosOffset + sinPhase * sinOffset) };
+        const float sines[2]{ sinPhase * cosOffset + cosPhase * sinOffset, cosPhase * sinOffset - sinPhase * cosOffset };
+
+        //without drift every turn reaches the same value, it only matters whether the arc passes the angle at all
+        if (drift == 0)
+        {
+            for (int root{}; root < 2; ++root)
+            {
+                if (sweep.Passes(cosines[root], sines[root])) range.Include(a + b * cosines[root] + c * sines[root]);
+            }
+            return range;
+        }
+
+        const float phase{ std::atan2(c, b) };
+        const float offset{ std::asin(sinOffset) };
+        const float roots[2]{ phase + offset, phase + g_TwoPi / 2 - offset };
+        for (int root{}; root < 2; ++root)
+        {
+            const float first{ std::ceil((sweep.theta0 - roots[root]) / g_TwoPi) };
+            const float last{ std::floor((sweep.theta1 - roots[root]) / g_TwoPi) };
+            if (first > last) continue;
+            const float value{ a + b * cosines[root] + c * sines[root] };
+            range.Include(value + drift * (roots[root] + g_TwoPi * first));
+            range.Include(value + drift * (roots[root] + g_TwoPi * last));
+        }
+        return range;
+    }
+
+    Vector MovedPoint(const ScrewMotion& motion, const ThreeBlade& point)
+    {
+        const ThreeBlade moved{ skinning::Transform(motion.Start(), point) };
+        return Vector{ moved[0] / moved[3], moved[1] / moved[3], moved[2] / moved[3] };
+    }
+
+    Vector MovedDirection(const ScrewMotion& motion, const ThreeBlade& direction)
+    {
+        const ThreeBlade moved{ skinning::Transform(motion.Start(), ThreeBlade{ direction[0], direction[1], direction[2], 0 }) };
+        return Vector{ moved[0], moved[1], moved[2] };
+    }
+
+    constexpr Vector g_Axes[3]{ { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+
+    // Grows bounds by the swept range of a point, extent is added on both sides
+    void IncludePoint(const Sweep& sweep, const Vector& q, const float extent[3], Range bounds[3])
+    {
+        for (int axis{}; axis < 3; ++axis)
+        {
+            const Range range{ SweptRange(sweep, q, false, g_Axes[axis]) };
+            bounds[axis].Include(range.min - extent[axis]);
+            bounds[axis].Include(range.max + extent[axis]);
+        }
+    }
+
+    Box ToBox(const Range bounds[3])
+    {
+        return Box{ ThreeBlade{ bounds[0].min, bounds[1].min, bounds[2].min }, ThreeBlade{ bounds[0].max, bounds[1].max, bounds[2].max } };
+    }
+}
+
+ScrewMotion ScrewMotion::FromVelocity(const Motor& start, const TwoBlade& velocity)
+{
+    //(1 + dt * velocity) moves p by dt * (omega x p + v) with omega = -2 (e23, e31, e12) and v = -2 (e01, e02, e03)
+    const Vector omega{ -2 * velocity[3], -2 * velocity[4], -2 * velocity[5] };
+    const Vector linear{ -2 * velocity[0], -2 * velocity[1], -2 * velocity[2] };
+
+    ScrewMotion motion{};
+    motion.m_Start = start;
+    const float speed{ std::sqrt(Dot(omega, omega)) };
+    if (speed < g_MinAngularSpeed)
+    {
+        const float length{ std::sqrt(Dot(linear, linear)) };
+        if (length > 0)
+        {
+            motion.m_Axis[0] = linear.x / length;
+            motion.m_Axis[1] = linear.y / length;
+            motion.m_Axis[2] = linear.z / length;
+        }
+        motion.m_AxialSpeed = length;
+        return motion;
+    }
+
+    //the axis passes through omega x v / |omega|^2, what is left of v runs along it
+    const Vector center{ Cross(omega, linear) };
+    motion.m_Axis[0] = omega.x / speed;
+    motion.m_Axis[1] = omega.y / speed;
+    motion.m_Axis[2] = omega.z / speed;
+    motion.m_Center[0] = center.x / (speed * speed);
+    motion.m_Center[1] = center.y / (speed * speed);
+    motion.m_Center[2] = center.z / (speed * speed);
+    motion.m_AngularSpeed = speed;
+    motion.m_AxialSpeed = Dot(omega, linear) / speed;
+    return motion;
+}
+
+ScrewMotion ScrewMotion::Between(const Motor& from, const Motor& to)
+{
+    Motor delta{ skinning::Renormalize(to * ~from) };
+    //M and -M are the same motion, the one with a positive scalar turns the short way round
+    if (delta[0] < 0)
+    {
+        for (size_t component{}; component < 8; ++component) delta[component] = -delta[component];
+    }
+
+    ScrewMotion motion{};
+    motion.m_Start = from;
+    const ThreeBlade origin{ skinning::Transform(delta, ThreeBlade{ 0, 0, 0 }) };
+    const Vector translation{ origin[0], origin[1], origin[2] };
+
+    const Vector bivector{ delta[4], delta[5], delta[6] };
+    const float sine{ std::sqrt(Dot(bivector, bivector)) };
+    const float angle{ 2 * std::atan2(sine, delta[0]) };
+    if (angle < g_MinAngularSpeed)
+    {
+        const float length{ std::sqrt(Dot(translation, translation)) };
+        if (length > 0)
+        {
+            motion.m_Axis[0] = translation.x / length;
+            motion.m_Axis[1] = translation.y / length;
+            motion.m_Axis[2] = translation.z / length;
+        }
+        motion.m_AxialSpeed = length;
+        return motion;
+    }
+
+    //the rotor bivector is -sin(angle / 2) times the axis
+    const Vector n{ -bivector.x / sine, -bivector.y / sine, -bivector.z / sine };
+    const float axial{ Dot(n, translation) };
+    const Vector across{ translation.x - axial * n.x, translation.y - axial * n.y, translation.z - axial * n.z };
+    //rotating by angle around an axis through c moves the origin by (I - R) c, solved for c
+    const Vector turned{ Cross(n, across) };
+    const float cotangent{ 1 / std::tan(angle / 2) };
+    motion.m_Axis[0] = n.x;
+    motion.m_Axis[1] = n.y;
+    motion.m_Axis[2] = n.z;
+    motion.m_Center[0] = (across.x + cotangent * turned.x) / 2;
+    motion.m_Center[1] = (across.y + cotangent * turned.y) / 2;
+    motion.m_Center[2] = (across.z + cotangent * turned.z) / 2;
+    motion.m_AngularSpeed = angle;
+    motion.m_AxialSpeed = axial;
+    return motion;
+}
+
+Motor ScrewMotion::At(float t) const
+{
+    const float half{ m_AngularSpeed * t / 2 };
+    const float sine{ std::sin(half) };
+    //rotation around the axis through the center, then the slide along it
+    const Motor rotation{ std::cos(half), 0, 0, 0, -sine * m_Axis[0], -sine * m_Axis[1], -sine * m_Axis[2], 0 };
+    const Motor fromOrigin{ 1, -m_Center[0] / 2, -m_Center[1] / 2, -m_Center[2] / 2, 0, 0, 0, 0 };
+    const Motor toOrigin{ 1, m_Center[0] / 2, m_Center[1] / 2, m_Center[2] / 2, 0, 0, 0, 0 };
+    const float shift{ -m_AxialSpeed * t / 2 };
+    const Motor slide{ 1, shift * m_Axis[0], shift * m_Axis[1], shift * m_Axis[2], 0, 0, 0, 0 };
+    return slide * fromOrigin * rotation * toOrigin * m_Start;
+}
+
+namespace sweep
+{
+    Box SweptBounds(const ScrewMotion& motion, const ThreeBlade& point, float t0, float t1)
+    {
+        const float extent[3]{};
+        Range bounds[3]{};
+        IncludePoint(Sweep{ motion, t0, t1 }, MovedPoint(motion, point), extent, bounds);
+        return ToBox(bounds);
+    }
+
+    Box SweptBounds(const ScrewMotion& motion, const Sphere& sphere, float t0, float t1)
+    {
+        const float extent[3]{ sphere.radius, sphere.radius, sphere.radius };
+        Range bounds[3]{};
+        IncludePoint(Sweep{ motion, t0, t1 }, MovedPoint(motion, sphere.center), extent, bounds);
+        return ToBox(bounds);
+    }
+
+    Box SweptBounds(const ScrewMotion& motion, const Box& box, float t0, float t1)
+    {
+        //the bounds of a box at any moment are those of its corners, so the swept corners are exact
+        const Sweep sweep{ motion, t0, t1 };
+        const float extent[3]{};
+        Range bounds[3]{};
+        for (int corner{}; corner < 8; ++corner)
+        {
+            const ThreeBlade point{
+                (corner & 1) ? box.max[0] : box.min[0],
+                (corner & 2) ? box.max[1] : box.min[1],
+                (corner & 4) ? box.max[2] : box.min[2] };
+            IncludePoint(sweep, MovedPoint(motion, point), extent, bounds);
+        }
+        return ToBox(bounds);
+    }
+
+    Box SweptBounds(const ScrewMotion& motion, const Disc& disc, float t0, float t1)
+    {
+        //a disc reaches r sqrt(1 - n_i^2) along axis i, bounded with the smallest |n_i| the sweep gets to
+        Vector normal{ MovedDirection(motion, disc.normal) };
+        const float length{ std::sqrt(Dot(normal, normal)) };
+        normal = Vector{ normal.x / length, normal.y / length, normal.z / length };
+
+        const Sweep sweep{ motion, t0, t1 };
+        float extent[3]{};
+        for (int axis{}; axis < 3; ++axis)
+        {
+            const Range tilt{ SweptRange(sweep, normal, true, g_Axes[axis]) };
+            const float closest{ (tilt.min <= 0 && tilt.max >= 0) ? 0.f : std::min(std::fabs(tilt.min), std::fabs(tilt.max)) };
+            extent[axis] = disc.radius * std::sqrt(std::max(0.f, 1 - closest * closest));
+        }
+
+        Range bounds[3]{};
+        IncludePoint(sweep, MovedPoint(motion, disc.center), extent, bounds);
+        return ToBox(bounds);
+    }
+
+    void SweptBounds(const ScrewMotion& motion, const PointBatch& points, float t0, float t1, PointBatch& mins, PointBatch& maxs)
+    {
+        const size_t count{ points.Size() };
+        mins.Resize(count);
+        maxs.Resize(count);
+        const Sweep sweep{ motion, t0, t1 };
+        const float extent[3]{};
+        for (size_t idx{}; idx < count; ++idx)
+        {
+            Range bounds[3]{};
+            IncludePoint(sweep, MovedPoint(motion, points.Get(idx)), extent, bounds);
+            const Box box{ ToBox(bounds) };
+            mins.Set(idx, box.min);
+            maxs.Set(idx, box.max);
+        }
+    }
+
+    void SweptBounds(const std::vector<ScrewMotion>& motions, const std::vector<Box>& boxes, float t0, float t1, std::vector<Box>& out)
+    {
+        const size_t count{ std::min(motions.size(), boxes.size()) };
+        out.resize(count);
+        for (size_t idx{}; idx < count; ++idx) out[idx] = SweptBounds(motions[idx], boxes[idx], t0, t1);
+    }
+
+    void SweptPlanes(const ScrewMotion& motion, const PointBatch& points, const std::vector<ThreeBlade>& directions,
+        float t0, float t1, PlaneBatch& out)
+    {
+        std::vector<Vector> moved{};
+        moved.reserve(points.Size());
+        for (size_t idx{}; idx < points.Size(); ++idx) moved.push_back(MovedPoint(motion, points.Get(idx)));
+
+        const Sweep sweep{ motion, t0, t1 };
+        out.Clear();
+        for (const ThreeBlade& direction : directions)
+        {
+            const float length{ std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]) };
+            const Vector d{ direction[0] / length, direction[1] / length, direction[2] / length };
+            float height{ -std::numeric_limits<float>::infinity() };
+            for (const Vector& point : moved) height = std::max(height, SweptRange(sweep, point, false, d).max);
+            out.PushBack(OneBlade{ -height, d.x, d.y, d.z });
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+#include "Raycast.h"
+
+// Flat disc around center, normal is a direction (w = 0)
+struct Disc
+{
+    ThreeBlade center;
+    ThreeBlade normal;
+    float radius;
+};
+
+// Constant velocity screw applied on top of a start motor: M(t) = exp(t * velocity) * start.
+// Every point runs along a helix around one axis, which is what makes exact bounds cheap.
+class ScrewMotion
+{
+public:
+    ScrewMotion() = default;
+
+    // velocity is the bivector in FlyFish component order, (1 + dt * velocity) * M is one small step
+    [[nodiscard]] static ScrewMotion FromVelocity(const Motor& start, const TwoBlade& velocity);
+    // The shortest screw with M(0) = from and M(1) = to
+    [[nodiscard]] static ScrewMotion Between(const Motor& from, const Motor& to);
+
+    [[nodiscard]] Motor At(float t) const;
+
+    [[nodiscard]] const Motor& Start() const { return m_Start; }
+    // Unit direction of the screw axis, the direction of travel for a pure translation
+    [[nodiscard]] const float* Axis() const { return m_Axis; }
+    // A point on the screw axis
+    [[nodiscard]] const float* Center() const { return m_Center; }
+    // Radians per unit of t, 0 for a pure translation
+    [[nodiscard]] float AngularSpeed() const { return m_AngularSpeed; }
+    // Distance along the axis per unit of t
+    [[nodiscard]] float AxialSpeed() const { return m_AxialSpeed; }
+
+private:
+    Motor m_Start{ 1, 0, 0, 0, 0, 0, 0, 0 };
+    float m_Axis[3]{ 1, 0, 0 };
+    float m_Center[3]{};
+    float m_AngularSpeed{};
+    float m_AxialSpeed{};
+};
+
+namespace sweep
+{
+    // Exact axis aligned bounds of everything the shape covers while t runs over [t0, t1], t0 <= t1.
+    // Shapes are given in the frame the motion moves, the trajectory is solved for, not sampled.
+    [[nodiscard]] Box SweptBounds(const ScrewMotion& motion, const ThreeBlade& point, float t0, float t1);
+    [[nodiscard]] Box SweptBounds(const ScrewMotion& motion, const Sphere& sphere, float t0, float t1);
+    [[nodiscard]] Box SweptBounds(const ScrewMotion& motion, const Box& box, float t0, float t1);
+    // Conservative: the center and the tilt of the disc are bounded separately
+    [[nodiscard]] Box SweptBounds(const ScrewMotion& motion, const Disc& disc, float t0, float t1);
+
+    // One motion, many points: mins[i] and maxs[i] bound points[i], both are resized to points.Size()
+    void SweptBounds(const ScrewMotion& motion, const PointBatch& points, float t0, float t1, PointBatch& mins, PointBatch& maxs);
+    // Broadphase form, motions[i] moves boxes[i], out is resized to the shorter of the two
+    void SweptBounds(const std::vector<ScrewMotion>& motions, const std::vector<Box>& boxes, float t0, float t1, std::vector<Box>& out);
+
+    // Plane set bounds of the swept convex hull of points, one plane per direction (w = 0).
+    // The planes face outward like ConvexShape faces, (plane & point) <= 0 for everything swept.
+    void SweptPlanes(const ScrewMotion& motion, const PointBatch& points, const std::vector<ThreeBlade>& directions,
+        float t0, float t1, PlaneBatch& out);
+}
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BatchFile.h"
+#include "ElementText.h"
+#include "FlyFish.h"
+#include "FlyFishBatch.h"
+#include "Skinning.h"
+
+// Moves every point of a point batch file by a chain of motors and writes the result to a new file.
+// The input is mapped, not read, and the output streams out chunk by chunk: while one chunk is written
+// the next one is transformed, so disk and compute overlap and memory use stays at two chunks.
+namespace
+{
+	constexpr size_t g_DefaultChunkSize{ 1 << 20 };
+
+	struct Options
+	{
+		unsigned threads{};
+		size_t chunkSize{ g_DefaultChunkSize };
+		size_t generateCount{};
+		std::string input{};
+		std::string output{};
+		std::vector<Motor> motors{};
+	};
+
+	void PrintUsage()
+	{
+		std::printf(
+			"usage: GEOATransform [--threads n] [--chunk points] input output motor...\n"
+			"       GEOATransform [--chunk points] --generate count output\n"
+			"\n"
+			"Files are point batch files. Motors are written like FlyFish prints them, e.g. \"0.7071 + 0.7071*e12\"\n"
+			"or \"1 - 5*e01\", and are applied in the order given.\n");
+	}
+
+	bool ParseMotor(const char* first, Motor& motor)
+	{
+		const char* last{ first + std::strlen(first) };
+		return text::Parse(first, last, motor) == last;
+	}
+
+	bool ParseCount(const char* first, size_t& count)
+	{
+		char* end{};
+		count = static_cast<size_t>(std::strtoull(first, &end, 10));
+		return end != first && *end == '\0';
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		std::vector<const char*> positional{};
+		for (int idx{ 1 }; idx < argc; ++idx)
+		{
+			const bool hasValue{ idx + 1 < argc };
+			size_t value{};
+			if (std::strcmp(argv[idx], "--threads") == 0 && hasValue && ParseCount(argv[idx + 1], value))
+			{
+				options.threads = static_cast<unsigned>(value);
+				++idx;
+			}
+			else if (std::strcmp(argv[idx], "--chunk") == 0 && hasValue && ParseCount(argv[idx + 1], value) && value > 0)
+			{
+				options.chunkSize = value;
+				++idx;
+			}
+			else if (std::strcmp(argv[idx], "--generate") == 0 && hasValue && ParseCount(argv[idx + 1], value))
+			{
+				options.generateCount = value;
+				++idx;
+			}
+			else if (argv[idx][0] == '-' && argv[idx][1] == '-')
+			{
+				return false;
+			}
+			else
+			{
+				positional.push_back(argv[idx]);
+			}
+		}
+
+		if (options.generateCount > 0)
+		{
+			if (positional.size() != 1) return false;
+			options.output = positional[0];
+			return true;
+		}
+
+		if (positional.size() < 3) return false;
+		options.input = positional[0];
+		options.output = positional[1];
+		for (size_t idx{ 2 }; idx < positional.size(); ++idx)
+		{
+			Motor motor{};
+			if (!ParseMotor(positional[idx], motor))
+			{
+				std::printf("not a motor: %s\n", positional[idx]);
+				return false;
+			}
+			options.motors.push_back(motor);
+		}
+		return true;
+	}
+
+	void PrintThroughput(const char* what, size_t count, std::chrono::steady_clock::time_point start)
+	{
+		const double seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+		//every point is read once and written once, four floats each way
+		const double bytes{ static_cast<double>(count) * 4 * sizeof(float) * 2 };
+		std::printf("%s %zu points in %.3f s: %.0f points/s, %.1f MB/s\n",
+			what, count, seconds, static_cast<double>(count) / seconds, bytes / seconds / 1e6);
+	}
+
+	// out = motor applied to points first .. first + count, split over threads on 64 byte boundaries
+	void TransformChunk(const Motor& motor, PointBatch& points, size_t first, size_t count, PointBatch& out, unsigned threads)
+	{
+		out.Resize(count);
+		const auto work{ [&](unsigned thread)
+			{
+				const size_t begin{ count * thread / threads / 16 * 16 };
+				const size_t end{ thread + 1 == threads ? count : count * (thread + 1) / threads / 16 * 16 };
+				const PointBatch source{ PointBatch::View(points.Component(0) + first + begin, end - begin, points.Stride()) };
+				PointBatch target{ PointBatch::View(out.Component(0) + begin, end - begin, out.Stride()) };
+				skinning::TransformPoints(motor, source, target);
+			} };
+
+		std::vector<std::thread> workers{};
+		workers.reserve(threads - 1);
+		for (unsigned thread{ 1 }; thread < threads; ++thread) workers.emplace_back(work, thread);
+		work(0);
+		for (std::thread& worker : workers) worker.join();
+	}
+
+	int Generate(const Options& options)
+	{
+		batchfile::Writer writer{};
+		if (!writer.Open(options.output, batchfile::ElementType::Point, options.generateCount))
+		{
+			std::printf("could not create %s\n", options.output.c_str());
+			return 1;
+		}
+
+		std::mt19937 random{ 1234 };
+		std::uniform_real_distribution<float> distribution{ -100.f, 100.f };
+		PointBatch chunk{};
+		for (size_t first{}; first < options.generateCount; first += options.chunkSize)
+		{
+			const size_t size{ std::min(options.chunkSize, options.generateCount - first) };
+			chunk.Clear();
+			for (size_t idx{}; idx < size; ++idx)
+			{
+				chunk.PushBack(ThreeBlade{ distribution(random), distribution(random), distribution(random) });
+			}
+			if (!writer.Write(first, chunk))
+			{
+				std::printf("could not write %s\n", options.output.c_str());
+				return 1;
+			}
+		}
+		return writer.Close() ? 0 : 1;
+	}
+
+	int Transform(const Options& options)
+	{
+		//the motor applied first is the rightmost factor
+		Motor motor{ 1, 0, 0, 0, 0, 0, 0, 0 };
+		for (const Motor& next : options.motors) motor = next * motor;
+
+		const auto start{ std::chrono::steady_clock::now() };
+		batchfile::MappedFile input{};
+		PointBatch points{};
+		if (!input.Open(options.input) || !input.View(points))
+		{
+			std::printf("%s is not a point batch file written on a machine with this byte order\n", options.input.c_str());
+			return 1;
+		}
+
+		batchfile::Writer writer{};
+		if (!writer.Open(options.output, batchfile::ElementType::Point, points.Size()))
+		{
+			std::printf("could not create %s\n", options.output.c_str());
+			return 1;
+		}
+
+		const unsigned threads{ options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.threads };
+		const size_t count{ points.Size() };
+		PointBatch buffers[2]{ PointBatch(options.chunkSize), PointBatch(options.chunkSize) };
+		std::future<bool> pendingWrite{};
+		bool written{ true };
+		input.Prefetch(0, options.chunkSize);
+
+		for (size_t first{}, chunk{}; first < count; first += options.chunkSize, ++chunk)
+		{
+			const size_t size{ std::min(options.chunkSize, count - first) };
+			input.Prefetch(first + size, options.chunkSize);
+
+			//the other buffer may still be on its way to disk, this one was written two chunks ago
+			PointBatch& buffer{ buffers[chunk % 2] };
+			TransformChunk(motor, points, first, size, buffer, threads);
+
+			if (pendingWrite.valid()) written = pendingWrite.get() && written;
+			pendingWrite = std::async(std::launch::async, [&writer, &buffer, first] { return writer.Write(first, buffer); });
+		}
+		if (pendingWrite.valid()) written = pendingWrite.get() && written;
+
+		if (!writer.Close() || !written)
+		{
+			std::printf("could not write %s\n", options.output.c_str());
+			return 1;
+		}
+		PrintThroughput("transformed", count, start);
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options{};
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+	return options.generateCount > 0 ? Generate(options) : Transform(options);
+}